@@ -0,0 +1,284 @@
+// Runs the same callbacks through both dispatch paths of the mock backend: RunCallbacks
+// handing each one to a std::function (the stock SteamAPI_RunCallbacks model) and manual
+// dispatch through SteamCallbackDispatcher's table. Also times call result routing and
+// the flat call map on its own, and counts heap allocations inside every timed loop.
+// The mock's RunCallbacks has none of steam_api's own bookkeeping, so the first two only
+// compare the dispatch itself. So far that comes out even, which is why
+// ManualCallbackDispatch stays off by default.
+// Usage: callback-bench [maxCallbacksPerFrame]
+#include "mock_steam_backend.hpp"
+#include "steam_callback_dispatcher.hpp"
+#include <steam/isteamfriends.h>
+#include <steam/isteamuser.h>
+#include <steam/isteamutils.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    std::atomic<uint64_t> g_allocations{0};
+}
+
+// Everything the process allocates comes through here, so the timed loops can be checked
+void* operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+namespace {
+    const uint32_t kFrames = 64;
+    const size_t kRounds = 20;
+
+    struct Counts {
+        uint64_t connected = 0;
+        uint64_t connectFailures = 0;
+        uint64_t disconnected = 0;
+        uint64_t overlay = 0;
+        uint64_t persona = 0;
+        uint64_t country = 0;
+        uint64_t battery = 0;
+        uint64_t shutdown = 0;
+        uint64_t tickets = 0;
+
+        uint64_t Total() const {
+            return connected + connectFailures + disconnected + overlay + persona + country + battery + shutdown;
+        }
+    };
+
+    // A mix of small callbacks a launcher or game actually sees
+    struct CallbackType {
+        int id;
+        size_t size;
+    };
+
+    template <typename Callback>
+    constexpr CallbackType TypeOf() {
+        return CallbackType{ Callback::k_iCallback, sizeof(Callback) };
+    }
+
+    const CallbackType kTypes[] = {
+        TypeOf<SteamServersConnected_t>(),
+        TypeOf<SteamServerConnectFailure_t>(),
+        TypeOf<SteamServersDisconnected_t>(),
+        TypeOf<GameOverlayActivated_t>(),
+        TypeOf<PersonaStateChange_t>(),
+        TypeOf<IPCountry_t>(),
+        TypeOf<LowBatteryPower_t>(),
+        TypeOf<SteamShutdown_t>(),
+    };
+    const size_t kTypeCount = sizeof(kTypes) / sizeof(kTypes[0]);
+
+    void OnConnected(Counts& counts, const SteamServersConnected_t&) { counts.connected++; }
+    void OnConnectFailure(Counts& counts, const SteamServerConnectFailure_t& callback) { counts.connectFailures += 1 + callback.m_bStillRetrying; }
+    void OnDisconnected(Counts& counts, const SteamServersDisconnected_t& callback) { counts.disconnected += 1 + (callback.m_eResult == k_EResultOK); }
+    void OnOverlay(Counts& counts, const GameOverlayActivated_t& callback) { counts.overlay += 1 + callback.m_bActive; }
+    void OnPersona(Counts& counts, const PersonaStateChange_t& callback) { counts.persona += 1 + (callback.m_nChangeFlags != 0); }
+    void OnCountry(Counts& counts, const IPCountry_t&) { counts.country++; }
+    void OnBattery(Counts& counts, const LowBatteryPower_t& callback) { counts.battery += 1 + (callback.m_nMinutesBatteryLeft != 0); }
+    void OnShutdown(Counts& counts, const SteamShutdown_t&) { counts.shutdown++; }
+    void OnTicket(Counts& counts, const EncryptedAppTicketResponse_t& result, bool failed) { counts.tickets += 1 + (failed || result.m_eResult != k_EResultOK); }
+
+    constexpr SteamCallbackTable<Counts, kTypeCount> kTable{ std::array<SteamCallbackRoute<Counts>, kTypeCount>{ {
+        MakeCallbackRoute<Counts, SteamServersConnected_t, &OnConnected>(),
+        MakeCallbackRoute<Counts, SteamServerConnectFailure_t, &OnConnectFailure>(),
+        MakeCallbackRoute<Counts, SteamServersDisconnected_t, &OnDisconnected>(),
+        MakeCallbackRoute<Counts, GameOverlayActivated_t, &OnOverlay>(),
+        MakeCallbackRoute<Counts, PersonaStateChange_t, &OnPersona>(),
+        MakeCallbackRoute<Counts, IPCountry_t, &OnCountry>(),
+        MakeCallbackRoute<Counts, LowBatteryPower_t, &OnBattery>(),
+        MakeCallbackRoute<Counts, SteamShutdown_t, &OnShutdown>(),
+    } } };
+    static_assert(kTable.IsValid(), "duplicate callback in the bench table");
+
+    // The stock path's equivalent of the table, what a handler on RunCallbacks ends up doing
+    void Dispatch(Counts& counts, const MockSteamCallback& callback) {
+        const void* data = callback.payload.data();
+        switch (callback.id) {
+            case SteamServersConnected_t::k_iCallback: OnConnected(counts, *static_cast<const SteamServersConnected_t*>(data)); break;
+            case SteamServerConnectFailure_t::k_iCallback: OnConnectFailure(counts, *static_cast<const SteamServerConnectFailure_t*>(data)); break;
+            case SteamServersDisconnected_t::k_iCallback: OnDisconnected(counts, *static_cast<const SteamServersDisconnected_t*>(data)); break;
+            case GameOverlayActivated_t::k_iCallback: OnOverlay(counts, *static_cast<const GameOverlayActivated_t*>(data)); break;
+            case PersonaStateChange_t::k_iCallback: OnPersona(counts, *static_cast<const PersonaStateChange_t*>(data)); break;
+            case IPCountry_t::k_iCallback: OnCountry(counts, *static_cast<const IPCountry_t*>(data)); break;
+            case LowBatteryPower_t::k_iCallback: OnBattery(counts, *static_cast<const LowBatteryPower_t*>(data)); break;
+            case SteamShutdown_t::k_iCallback: OnShutdown(counts, *static_cast<const SteamShutdown_t*>(data)); break;
+        }
+    }
+
+    struct Result {
+        double seconds = 0;
+        uint64_t allocations = 0;
+        uint64_t operations = 0;
+    };
+
+    // Times fn and counts what it allocates
+    template <typename Fn>
+    void Measure(Result& result, Fn&& fn) {
+        uint64_t allocations = g_allocations.load(std::memory_order_relaxed);
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        result.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.allocations += g_allocations.load(std::memory_order_relaxed) - allocations;
+    }
+
+    void Report(const std::string& name, const Result& result) {
+        double nanos = result.seconds * 1e9 / static_cast<double>(result.operations);
+        std::cout << std::left << std::setw(34) << name
+                  << std::right << std::setw(10) << std::fixed << std::setprecision(1) << nanos << " ns/op"
+                  << std::setw(12) << std::setprecision(2) << (static_cast<double>(result.allocations) / static_cast<double>(result.operations)) << " allocs/op"
+                  << std::endl;
+    }
+
+    // Callbacks for the next kFrames frames, cycling through kTypes. Not timed, queueing allocates
+    void QueueCallbacks(MockSteamBackend& steam, uint32_t perFrame) {
+        for (uint32_t frame = 0; frame < kFrames; frame++) {
+            for (uint32_t i = 0; i < perFrame; i++) {
+                const CallbackType& type = kTypes[(frame * perFrame + i) % kTypeCount];
+                steam.QueueCallback(type.id, std::vector<uint8_t>(type.size), frame);
+            }
+        }
+    }
+
+    void Check(const char* path, uint64_t delivered, uint64_t expected) {
+        if (delivered != expected) {
+            std::cout << "  " << path << " delivered " << delivered << " of " << expected << std::endl;
+        }
+    }
+
+    Result BenchRunCallbacks(uint32_t perFrame) {
+        MockSteamBackend steam;
+        std::string error;
+        steam.Init(error);
+        Counts counts;
+        steam.SetCallbackHandler([&counts](const MockSteamCallback& callback) { Dispatch(counts, callback); });
+
+        Result result;
+        uint64_t delivered = 0;
+        for (size_t round = 0; round < kRounds; round++) {
+            QueueCallbacks(steam, perFrame);
+            Measure(result, [&] {
+                for (uint32_t frame = 0; frame < kFrames; frame++) {
+                    delivered += steam.RunCallbacks();
+                }
+            });
+        }
+        result.operations = kRounds * kFrames * perFrame;
+        Check("RunCallbacks", delivered, result.operations);
+        return result;
+    }
+
+    Result BenchManualDispatch(uint32_t perFrame) {
+        MockSteamBackend steam;
+        std::string error;
+        steam.Init(error);
+        steam.InitManualDispatch();
+        Counts counts;
+        SteamCallbackDispatcher<Counts, kTypeCount> dispatcher(steam, counts, kTable);
+
+        Result result;
+        for (size_t round = 0; round < kRounds; round++) {
+            QueueCallbacks(steam, perFrame);
+            Measure(result, [&] {
+                for (uint32_t frame = 0; frame < kFrames; frame++) {
+                    dispatcher.RunFrame();
+                }
+            });
+        }
+        result.operations = kRounds * kFrames * perFrame;
+        Check("manual dispatch", dispatcher.GetStats().callbacks, result.operations);
+        return result;
+    }
+
+    Result BenchCallResults(uint32_t perFrame) {
+        MockSteamBackend steam;
+        std::string error;
+        steam.Init(error);
+        steam.InitManualDispatch();
+        Counts counts;
+        SteamCallbackDispatcher<Counts, kTypeCount> dispatcher(steam, counts, kTable, kFrames * perFrame);
+
+        Result result;
+        uint64_t call = 1;
+        for (size_t round = 0; round < kRounds; round++) {
+            for (uint32_t frame = 0; frame < kFrames; frame++) {
+                for (uint32_t i = 0; i < perFrame; i++, call++) {
+                    steam.QueueCallResult(call, EncryptedAppTicketResponse_t::k_iCallback, std::vector<uint8_t>(sizeof(EncryptedAppTicketResponse_t)), frame);
+                }
+            }
+            // Waiting on a call is part of routing it, so it's timed too
+            Measure(result, [&] {
+                for (uint64_t waiting = call - kFrames * perFrame; waiting < call; waiting++) {
+                    dispatcher.AwaitCallResult<EncryptedAppTicketResponse_t, &OnTicket>(waiting);
+                }
+                for (uint32_t frame = 0; frame < kFrames; frame++) {
+                    dispatcher.RunFrame();
+                }
+            });
+        }
+        result.operations = kRounds * kFrames * perFrame;
+        Check("call results", dispatcher.GetStats().callResults, result.operations);
+        return result;
+    }
+
+    // The call map against what it replaces, insert then take in the order results come back
+    template <typename Insert, typename Take>
+    Result BenchMap(size_t calls, Insert insert, Take take) {
+        Result result;
+        for (size_t round = 0; round < kRounds; round++) {
+            uint64_t base = round * calls * 3 + 1;
+            Measure(result, [&] {
+                for (uint64_t call = 0; call < calls; call++) insert(base + call * 3);
+                for (uint64_t call = 0; call < calls; call++) take(base + call * 3);
+            });
+        }
+        result.operations = kRounds * calls * 2;
+        return result;
+    }
+
+    void OnAnyResult(Counts& counts, const void*, bool) {
+        counts.tickets++;
+    }
+}
+
+int main(int argc, char** argv) {
+    uint32_t maxPerFrame = argc > 1 ? static_cast<uint32_t>(std::stoul(argv[1])) : 256;
+    std::cout << "Steam callback dispatch benchmark (mock backend), " << kFrames << " frames x " << kRounds << " rounds" << std::endl << std::endl;
+
+    for (uint32_t perFrame = 1; perFrame <= maxPerFrame; perFrame *= 16) {
+        std::string label = std::to_string(perFrame) + "/frame";
+        Report(label + ", RunCallbacks", BenchRunCallbacks(perFrame));
+        Report(label + ", manual dispatch", BenchManualDispatch(perFrame));
+        Report(label + ", call results", BenchCallResults(perFrame));
+        std::cout << std::endl;
+    }
+
+    const size_t calls = 1024;
+    SteamCallResultMap<Counts> flat(calls);
+    SteamCallResultMap<Counts>::Entry entry;
+    Report("call map, flat", BenchMap(calls,
+        [&](uint64_t call) { flat.Insert({ call, 0, 0, &OnAnyResult }); },
+        [&](uint64_t call) { flat.Take(call, entry); }));
+    std::unordered_map<uint64_t, SteamCallResultMap<Counts>::Entry> unordered;
+    unordered.reserve(calls);
+    Report("call map, std::unordered_map", BenchMap(calls,
+        [&](uint64_t call) { unordered.emplace(call, SteamCallResultMap<Counts>::Entry{ call, 0, 0, &OnAnyResult }); },
+        [&](uint64_t call) { auto found = unordered.find(call); entry = found->second; unordered.erase(found); }));
+    return 0;
+}
@@ -0,0 +1,118 @@
+// Measures how fast IniConfig parses and looks up keys on synthetic configs from
+// 10 to 100k keys, so a slower parser shows up as a smaller number here.
+// Usage: config-bench [maxKeys]
+#include "ini_config.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    const size_t kKeysPerSection = 50;
+
+    struct Lookup {
+        std::string section;
+        std::string key;
+    };
+
+    // Looks like a real config: sections, comments, blank lines, values of different lengths
+    std::string MakeConfig(size_t keys) {
+        std::string text;
+        for (size_t i = 0; i < keys; i++) {
+            if (i % kKeysPerSection == 0) {
+                if (i > 0) text += "\n";
+                text += "[Section" + std::to_string(i / kKeysPerSection) + "]\n";
+                text += "; settings for part " + std::to_string(i / kKeysPerSection) + "\n";
+            }
+            text += "Key" + std::to_string(i) + " = value " + std::to_string(i * 7919) + std::string(i % 24, 'x') + "\n";
+        }
+        return text;
+    }
+
+    // Mostly hits in random order, every fourth lookup misses
+    std::vector<Lookup> MakeLookups(size_t keys, size_t count) {
+        std::mt19937 random(42);
+        std::vector<Lookup> lookups;
+        lookups.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            size_t key = random() % keys;
+            std::string name = i % 4 == 3 ? "Missing" + std::to_string(key) : "Key" + std::to_string(key);
+            lookups.push_back(Lookup{ "Section" + std::to_string(key / kKeysPerSection), name });
+        }
+        return lookups;
+    }
+
+    double Seconds(std::chrono::steady_clock::duration elapsed) {
+        return std::chrono::duration<double>(elapsed).count();
+    }
+
+    void Report(const std::string& name, double rate, const char* unit, double seconds, size_t runs) {
+        std::cout << std::left << std::setw(28) << name
+                  << std::right << std::setw(14) << std::fixed << std::setprecision(1) << rate << " " << std::left << std::setw(12) << unit
+                  << std::right << std::setw(10) << std::setprecision(3) << (seconds * 1000.0 / runs) << " ms/run" << std::endl;
+    }
+
+    void BenchKeys(size_t keys) {
+        std::string text = MakeConfig(keys);
+        std::string path = (std::filesystem::temp_directory_path() / ("uc_online_bench_" + std::to_string(keys) + ".ini")).string();
+        // Aim for roughly the same amount of work at every size
+        size_t runs = std::max<size_t>(3, 2000000 / (text.size() + 1));
+        double megabytes = text.size() * static_cast<double>(runs) / (1024.0 * 1024.0);
+        std::string label = std::to_string(keys) + " keys";
+
+        // Parse only, the text is already in memory
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < runs; i++) {
+            IniConfig config(path, text);
+        }
+        double seconds = Seconds(std::chrono::steady_clock::now() - start);
+        Report(label + ", parse", megabytes / seconds, "MB/s", seconds, runs);
+
+        // Read from disk and parsed, what a launcher start pays
+        {
+            std::ofstream(path, std::ios::binary) << text;
+            IniConfig config(path);
+            start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < runs; i++) {
+                config.LoadConfig();
+            }
+            seconds = Seconds(std::chrono::steady_clock::now() - start);
+            Report(label + ", load", megabytes / seconds, "MB/s", seconds, runs);
+        }
+
+        IniConfig config(path, text);
+        std::vector<Lookup> lookups = MakeLookups(keys, 1 << 16);
+        size_t rounds = 16;
+        size_t found = 0;
+        start = std::chrono::steady_clock::now();
+        for (size_t round = 0; round < rounds; round++) {
+            for (const Lookup& lookup : lookups) {
+                found += config.GetValueView(lookup.section, lookup.key).size();
+            }
+        }
+        seconds = Seconds(std::chrono::steady_clock::now() - start);
+        double lookupsPerSecond = lookups.size() * static_cast<double>(rounds) / seconds;
+        Report(label + ", lookup", lookupsPerSecond / 1e6, "M lookups/s", seconds, rounds);
+        // Used so the loop can't be thrown away
+        if (found == 0) std::cout << "(no hits)" << std::endl;
+
+        std::filesystem::remove(path);
+        std::filesystem::remove(path + ".lock");
+        std::cout << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t maxKeys = argc > 1 ? std::stoul(argv[1]) : 100000;
+    std::cout << "IniConfig benchmark, up to " << maxKeys << " keys" << std::endl << std::endl;
+
+    for (size_t keys = 10; keys <= maxKeys; keys *= 10) {
+        BenchKeys(keys);
+    }
+    return 0;
+}
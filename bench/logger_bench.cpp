@@ -0,0 +1,78 @@
+// Compares logging throughput of the old open-per-line approach against the
+// persistent buffered writer under each flush policy, plus the async mode.
+// Usage: logger-bench [lines]
+#include "logger.hpp"
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace {
+    std::string BenchLogPath(const std::string& name) {
+        return (std::filesystem::temp_directory_path() / ("uc_online_bench_" + name + ".log")).string();
+    }
+
+    void Report(const std::string& name, size_t lines, std::chrono::steady_clock::duration elapsed) {
+        double seconds = std::chrono::duration<double>(elapsed).count();
+        std::cout << std::left << std::setw(28) << name
+                  << std::right << std::setw(14) << std::fixed << std::setprecision(0) << (lines / seconds) << " lines/sec"
+                  << std::setw(10) << std::setprecision(1) << (seconds * 1000.0) << " ms" << std::endl;
+    }
+
+    // What Logger::Log did before the file handle was kept open
+    void BenchOpenPerLine(size_t lines) {
+        std::string path = BenchLogPath("open_per_line");
+        std::filesystem::remove(path);
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < lines; i++) {
+            std::ofstream file(path, std::ios::app);
+            file << "2024-01-01 00:00:00 [INFO] Benchmark line " << i << "\n";
+        }
+        Report("open-per-line (old)", lines, std::chrono::steady_clock::now() - start);
+        std::filesystem::remove(path);
+    }
+
+    void BenchLogger(const std::string& name, const LoggerOptions& options, size_t lines) {
+        std::string path = BenchLogPath(name);
+        std::filesystem::remove(path);
+
+        auto start = std::chrono::steady_clock::now();
+        {
+            Logger logger(path, true, options);
+            for (size_t i = 0; i < lines; i++) {
+                logger.Log("Benchmark line " + std::to_string(i));
+            }
+            logger.Flush();
+        }
+        Report(name, lines, std::chrono::steady_clock::now() - start);
+        std::filesystem::remove(path);
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t lines = argc > 1 ? std::stoul(argv[1]) : 20000;
+    std::cout << "Logger benchmark, " << lines << " lines per run" << std::endl << std::endl;
+
+    BenchOpenPerLine(lines);
+
+    LoggerOptions options;
+    options.flushPolicy = LogFlushPolicy::EveryLine;
+    BenchLogger("persistent, flush=line", options, lines);
+
+    options.flushPolicy = LogFlushPolicy::Bytes;
+    BenchLogger("persistent, flush=bytes", options, lines);
+
+    options.flushPolicy = LogFlushPolicy::Interval;
+    BenchLogger("persistent, flush=interval", options, lines);
+
+    options.flushPolicy = LogFlushPolicy::OnError;
+    BenchLogger("persistent, flush=error", options, lines);
+
+    options.flushPolicy = LogFlushPolicy::EveryLine;
+    options.asyncLogging = true;
+    BenchLogger("async", options, lines);
+
+    return 0;
+}
@@ -0,0 +1,209 @@
+// Feeds arbitrary text to IniConfig and checks that load, save and reload round-trip:
+// untouched lines come back byte for byte and every value reads the same afterwards.
+// Built with libFuzzer when the compiler has it (clang -fsanitize=fuzzer), otherwise
+// as a plain program that runs the files it's given, or the built-in edge cases plus
+// random mutations of them.
+// Usage: ini-config-fuzz [file...]          standalone build
+//        ini-config-fuzz [corpus dir] [-runs=N]   libFuzzer build
+#include "ini_config.hpp"
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    const char* const kFuzzSection = "uc-online-fuzz";
+    const char* const kFuzzKey = "Marker";
+
+    // Keeps what SaveConfig would have written instead of touching the disk
+    class MemoryWriter : public FileWriter {
+    public:
+        bool Write(const std::string&, std::string_view contents) override {
+            written.assign(contents);
+            writes++;
+            return true;
+        }
+
+        std::string written;
+        int writes = 0;
+    };
+
+    struct KeyState {
+        bool present;
+        std::string value;
+    };
+
+    // Never created, SaveConfig finds nothing on disk and doesn't try to merge
+    const std::string& FuzzPath() {
+        static const std::string path = (std::filesystem::temp_directory_path() / "uc_online_fuzz.ini").string();
+        return path;
+    }
+
+    void Check(bool condition, const char* what, const std::string& input) {
+        if (condition) return;
+        std::cerr << "ini-config-fuzz: " << what << std::endl;
+        std::cerr << "input (" << input.size() << " bytes):" << std::endl << input << std::endl;
+        std::abort();
+    }
+
+    std::vector<KeyState> ReadSchemaKeys(const IniConfig& config) {
+        std::vector<KeyState> state;
+        for (const ConfigSchema::KeyInfo& info : ConfigSchema::kKeys) {
+            state.push_back(KeyState{ config.HasValue(info.section, info.name), config.GetValue(info.section, info.name) });
+        }
+        return state;
+    }
+
+    void CheckSchemaKeys(const IniConfig& config, const std::vector<KeyState>& expected, const std::string& input) {
+        for (size_t i = 0; i < ConfigSchema::kKeyCount; i++) {
+            const ConfigSchema::KeyInfo& info = ConfigSchema::kKeys[i];
+            Check(config.HasValue(info.section, info.name) == expected[i].present, "key appeared or vanished after reload", input);
+            Check(config.GetValue(info.section, info.name) == expected[i].value, "value changed after reload", input);
+        }
+    }
+
+    void RunOne(const std::string& input) {
+        auto writer = std::make_shared<MemoryWriter>();
+        IniConfig config(FuzzPath(), input, writer);
+        std::vector<KeyState> before = ReadSchemaKeys(config);
+
+        // Nothing changed, nothing written
+        config.SaveConfig();
+        Check(writer->writes == 0, "unchanged config was written", input);
+
+        // A new key in a new section goes at the end, everything before it stays as it was
+        bool hadFuzzSection = input.find(std::string("[") + kFuzzSection + "]") != std::string::npos;
+        config.SetValue(kFuzzSection, kFuzzKey, "1");
+        config.SaveConfig();
+        Check(writer->writes == 1, "changed config wasn't written", input);
+        std::string saved = writer->written;
+        if (!hadFuzzSection) {
+            Check(saved.compare(0, input.size(), input) == 0, "existing text changed when a key was added", input);
+        }
+
+        IniConfig reloaded(FuzzPath(), saved, writer);
+        CheckSchemaKeys(reloaded, before, input);
+        Check(reloaded.GetValue(kFuzzSection, kFuzzKey) == "1", "added key didn't survive reload", input);
+
+        // Change every schema key that is there, they all have to read back as written
+        std::vector<KeyState> changed = before;
+        {
+            ConfigTransaction transaction(reloaded);
+            for (size_t i = 0; i < ConfigSchema::kKeyCount; i++) {
+                if (!changed[i].present) continue;
+                changed[i].value = "fuzzed " + std::to_string(i);
+                reloaded.SetValue(ConfigSchema::kKeys[i].id, changed[i].value);
+            }
+        }
+        IniConfig rewritten(FuzzPath(), writer->written, writer);
+        CheckSchemaKeys(rewritten, changed, input);
+
+        // One changed key: the save is the input with exactly that value swapped, every byte
+        // around it (spacing, \r, what's after the value) as it was
+        for (size_t i = 0; i < ConfigSchema::kKeyCount; i++) {
+            if (!before[i].present) continue;
+            IniConfig single(FuzzPath(), input, writer);
+            const std::string& old = before[i].value;
+            const std::string value = "fuzzed";
+            single.SetValue(ConfigSchema::kKeys[i].id, value);
+            single.SaveConfig();
+            const std::string& out = writer->written;
+
+            size_t common = 0;
+            while (common < input.size() && common < out.size() && input[common] == out[common]) common++;
+            bool spliced = false;
+            size_t first = common > old.size() + value.size() ? common - old.size() - value.size() : 0;
+            for (size_t at = first; at <= common && at + old.size() <= input.size() && !spliced; at++) {
+                spliced = input.compare(at, old.size(), old) == 0 &&
+                          out.size() == input.size() - old.size() + value.size() &&
+                          out.compare(0, at, input, 0, at) == 0 &&
+                          out.compare(at, value.size(), value) == 0 &&
+                          out.compare(at + value.size(), std::string::npos, input, at + old.size(), std::string::npos) == 0;
+            }
+            Check(spliced, "changing one value touched more than the value", input);
+            break;
+        }
+    }
+
+    std::string ReadWholeFile(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    }
+
+    // The cases that were never tested before, the random runs start from these
+    std::vector<std::string> EdgeCases() {
+        return {
+            "",
+            "[",
+            "]",
+            "[]\nAppID=1\n",
+            "[uc-online\nAppID=1\n",
+            "AppID=730\n[uc-online]\nAppID=480",
+            "[uc-online]\nGameArguments=-a=1 -b=2\n",
+            "[uc-online]\r\nAppID=480\r\nGameExecutable=game.exe\r\n",
+            "[uc-online]\r\nAppID=480\nGameExecutable=game.exe\r\n",
+            "\xEF\xBB\xBF[uc-online]\nAppID=480\n",
+            "\xEF\xBB\xBF",
+            "[uc-online]\nAppID=\nAppID = 1 \n\n[uc-online]\nAppID=2\n",
+            "[Logging]\n; comment\n# other comment\nLogLevel=info ; not a comment\n",
+            "[uc-online]\n=\n==\nAppID\n  AppID  =  5  \t\r\n",
+            "[uc-online]\nAppID=1\r",
+            "[uc-online]\nAppID=480\nGameExecutable =game.exe  \r\nGameArguments=\v-x\f\n",
+            "[uc-online]\nAppID = \r\n",
+            std::string("[uc-online]\nAppID=1\0\n", 21),
+            ConfigSchema::DefaultConfigText(),
+        };
+    }
+
+    // Splices bytes the parser cares about into a seed, a poor man's libFuzzer
+    std::string Mutate(std::string text, std::mt19937& random) {
+        static const char kAlphabet[] = "[]=;#\r\n \t\xEF\xBB\xBF" "AppIDuc-online";
+        int edits = 1 + static_cast<int>(random() % 8);
+        for (int i = 0; i < edits; i++) {
+            size_t at = text.empty() ? 0 : random() % (text.size() + 1);
+            char c = kAlphabet[random() % (sizeof(kAlphabet) - 1)];
+            switch (random() % 3) {
+                case 0: text.insert(text.begin() + at, c); break;
+                case 1: if (at < text.size()) text.erase(at, 1 + random() % 4); break;
+                default: if (at < text.size()) text[at] = c; break;
+            }
+        }
+        return text;
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    RunOne(std::string(reinterpret_cast<const char*>(data), size));
+    return 0;
+}
+
+#ifndef UC_ONLINE_LIBFUZZER
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) {
+            RunOne(ReadWholeFile(argv[i]));
+        }
+        std::cout << "ini-config-fuzz: " << (argc - 1) << " files ok" << std::endl;
+        return 0;
+    }
+
+    std::vector<std::string> seeds = EdgeCases();
+    for (const std::string& seed : seeds) {
+        RunOne(seed);
+    }
+
+    // Fixed seed so a failure shows up the same way every time
+    std::mt19937 random(1234);
+    const int runs = 200000;
+    for (int i = 0; i < runs; i++) {
+        RunOne(Mutate(seeds[random() % seeds.size()], random));
+    }
+    std::cout << "ini-config-fuzz: " << seeds.size() << " edge cases and " << runs << " mutations ok" << std::endl;
+    return 0;
+}
+#endif
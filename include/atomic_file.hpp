@@ -0,0 +1,55 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+// How a whole file gets replaced on disk. IniConfig only talks to this, so the
+// platform details (and any fake used while poking at the config code) live elsewhere.
+class FileWriter {
+public:
+    virtual ~FileWriter() = default;
+    // Replaces path with contents, false if nothing was changed on disk
+    virtual bool Write(const std::string& path, std::string_view contents) = 0;
+};
+
+// Writes contents to <path>.tmp next to the target, flushes it all the way to
+// disk and then renames it over the original. Readers only ever see the old
+// file or the new one, never half of each, even if we crash in the middle.
+// Uses MoveFileEx on Windows and rename() on everything else.
+class AtomicFileWriter : public FileWriter {
+public:
+    // Without flushToDisk the rename is still atomic, but a power cut can lose the
+    // new contents. Fine for files that can be rebuilt, like the startup stats.
+    explicit AtomicFileWriter(bool flushToDisk = true);
+
+    bool Write(const std::string& path, std::string_view contents) override;
+
+    static std::shared_ptr<FileWriter> Default();
+
+private:
+    bool _flushToDisk;
+};
+
+// Advisory, exclusive lock on <path>.lock so launchers started at the same time
+// from one directory take turns writing the config. Other programs can still
+// open the file, this only keeps our own instances in line.
+class FileLock {
+public:
+    explicit FileLock(const std::string& path);
+    ~FileLock();
+
+    FileLock(const FileLock&) = delete;
+    FileLock& operator=(const FileLock&) = delete;
+
+    // False if the lock file couldn't be opened or locked, callers write anyway
+    bool IsLocked() const;
+
+private:
+#ifdef _WIN32
+    void* _handle = nullptr;
+#else
+    int _fd = -1;
+#endif
+    bool _locked = false;
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// On-disk layout of the binary log sink, shared with the uc-online-logcat reader.
+// Everything is little endian and there is no padding.
+//
+//   file    := magic entry*
+//   magic   := "UCLOGBIN"
+//   session := u8 type(1) u16 version u64 wallClockMicros
+//              written whenever a logger opens the file, monotonic times below are relative to it
+//   record  := u8 type(2) u8 level u16 sourceLength u32 messageLength
+//              u64 monotonicNs u64 threadId source message
+namespace BinaryLog {
+    constexpr char kMagic[8] = { 'U', 'C', 'L', 'O', 'G', 'B', 'I', 'N' };
+    constexpr uint16_t kVersion = 1;
+
+    constexpr uint8_t kSessionEntry = 1;
+    constexpr uint8_t kRecordEntry = 2;
+
+    constexpr size_t kSessionSize = 1 + 2 + 8;
+    constexpr size_t kRecordHeaderSize = 1 + 1 + 2 + 4 + 8 + 8;
+
+    inline void PutU16(std::string& out, uint16_t value) {
+        out.push_back(static_cast<char>(value));
+        out.push_back(static_cast<char>(value >> 8));
+    }
+
+    inline void PutU32(std::string& out, uint32_t value) {
+        for (int i = 0; i < 4; i++) {
+            out.push_back(static_cast<char>(value >> (8 * i)));
+        }
+    }
+
+    inline void PutU64(std::string& out, uint64_t value) {
+        for (int i = 0; i < 8; i++) {
+            out.push_back(static_cast<char>(value >> (8 * i)));
+        }
+    }
+
+    inline uint64_t GetLE(const unsigned char* data, int bytes) {
+        uint64_t value = 0;
+        for (int i = bytes - 1; i >= 0; i--) {
+            value = (value << 8) | data[i];
+        }
+        return value;
+    }
+}
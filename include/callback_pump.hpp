@@ -0,0 +1,76 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+struct CallbackPumpOptions {
+    // Frames per second while callbacks are coming in
+    uint32_t frequencyHz = 30;
+    // Each frame without a callback doubles the wait, up to this. At or below the busy
+    // interval there is no backing off at all
+    uint32_t maxIdleIntervalMs = 100;
+};
+
+// Runs Steam's callbacks on a thread of its own. Busy, it runs a frame every
+// 1/frequencyHz; idle, the gap doubles up to maxIdleIntervalMs. Wake() runs a frame
+// straight away and drops back to the fast rate, Stop() ends it without waiting out
+// the current gap. Everything that talks to Steam's callbacks has to go through here
+// while it's running, Steam wants them all on one thread.
+class CallbackPump {
+public:
+    // Runs one frame and returns how many callbacks it delivered. 0 counts as idle, a frame
+    // that can't tell should come with maxIdleIntervalMs = 0 so the pump never backs off
+    using Frame = std::function<uint32_t()>;
+
+    struct Stats {
+        uint64_t frames = 0;
+        uint64_t callbacks = 0;
+        std::chrono::nanoseconds dispatchTime{0};
+        // Over the last full second
+        uint32_t framesPerSecond = 0;
+        uint32_t callbacksPerSecond = 0;
+        std::chrono::nanoseconds dispatchTimePerSecond{0};
+        // Wait before the next frame, shows how far it has backed off
+        std::chrono::milliseconds currentInterval{0};
+    };
+
+    CallbackPump(Frame frame, const CallbackPumpOptions& options = CallbackPumpOptions());
+    // Stops the thread if it is still running
+    ~CallbackPump();
+
+    CallbackPump(const CallbackPump&) = delete;
+    CallbackPump& operator=(const CallbackPump&) = delete;
+
+    void Start();
+    // Blocks until the frame in progress (if any) is done and the thread has ended
+    void Stop();
+    void Wake();
+    bool IsRunning() const;
+    Stats GetStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Frame _frame;
+    std::chrono::milliseconds _busyInterval;
+    std::chrono::milliseconds _maxIdleInterval;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _wakeup;
+    // The stop token: set once by Stop(), the thread checks it before every frame and wait
+    bool _stopRequested = false;
+    bool _wakeRequested = false;
+    std::thread _thread;
+    Stats _stats;
+    // Counters for the second in progress
+    Clock::time_point _windowStart;
+    uint32_t _windowFrames = 0;
+    uint32_t _windowCallbacks = 0;
+    std::chrono::nanoseconds _windowDispatch{0};
+
+    void Run();
+};
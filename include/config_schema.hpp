@@ -0,0 +1,346 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+// Every key config.ini knows about, in one table: where it lives, what type it is,
+// its default and the comment written above it in a fresh config. Everything else
+// (the default file, the key lookup while parsing, the typed getters) is derived
+// from this table, so adding a key means adding one entry here and one enum value.
+namespace ConfigSchema {
+
+enum class Type : uint8_t {
+    UInt32,
+    Bool,
+    String,
+    Path,
+    Choice // one of a fixed list of words, stored as its position in that list
+};
+
+// Same order as kKeys, checked below
+enum class Key : uint8_t {
+    AppID,
+    GameExecutable,
+    GameArguments,
+    SteamAppIdFile,
+    SteamApiDLLPath,
+    WatchConfig,
+    PipelinedLaunch,
+    CallbackRateHz,
+    CallbackIdleMaxMs,
+    ManualCallbackDispatch,
+    ExitTimeoutSeconds,
+
+    EnableLogging,
+    LogFile,
+    LogLevel,
+    MaxLogSizeKB,
+    MaxLogAgeHours,
+    RetainedLogs,
+    CompressRotatedLogs,
+    FlushPolicy,
+    FlushBytes,
+    FlushIntervalMs,
+    WriteBufferSize,
+    TimestampPrecision,
+    TimestampClock,
+    Sinks,
+    JsonLogFile,
+    BinaryLogFile,
+    AsyncLogging,
+    AsyncQueueSize,
+    AsyncOverflowPolicy,
+
+    TraceStartup,
+    TraceFile,
+    TraceStatsFile,
+
+    Count
+};
+
+struct KeyInfo {
+    Key id;
+    std::string_view section;
+    std::string_view name;
+    Type type;
+    std::string_view defaultValue;
+    // Choice keys only, the allowed words separated by '|'
+    std::string_view choices;
+    // Written above the key in a fresh config, one "# " line per '\n' separated line
+    std::string_view comment;
+};
+
+inline constexpr KeyInfo kKeys[] = {
+    {Key::AppID, "uc-online", "AppID", Type::UInt32, "480", "",
+     "Set the appID to be used here, e.g., 730 for Counter-Strike 2)\n"
+     "(Please note that you will want to set it to a game you can get for free that is multiplayer. Anything else, and it won't work.)\n"
+     "Default appID is set to 480 (Spacewar), however you can change it to any appID you want."},
+    {Key::GameExecutable, "uc-online", "GameExecutable", Type::Path, "", "",
+     "Executable needs to be set directly. Unlike the dll, there is no 'default' for the exe.\n"
+     "Using UE5 games as an example, the correct launcher path will look like this:\n"
+     "game folder\\game folder\\Binaries\\Win64\\game folder-Win64-Shipping.exe"},
+    {Key::GameArguments, "uc-online", "GameArguments", Type::String, "", "",
+     "Set launch arguments where necessary - e.g., for Source Engine games like Half-Life: Source, set it to '-game hl1 -windowed' to launch it correctly."},
+    {Key::SteamAppIdFile, "uc-online", "SteamAppIdFile", Type::Path, "steam_appid.txt", "",
+     "Set the path to the steam_appid.txt file to use. (If one does not exist, it will be generated with the appID set at the top.)"},
+    {Key::SteamApiDLLPath, "uc-online", "SteamApiDLLPath", Type::Path, "", "",
+     "Path to steam_api.dll (leave empty to use default location - in the same folder next to the launcher.)\n"
+     "Only set the path as the folder containing the dll relative to the launcher.\n"
+     "Again, using UE5 games as an example:\n"
+     "game folder\\Engine\\Binaries\\ThirdParty\\Steamworks\\Steamv153\\Win64"},
+    {Key::WatchConfig, "uc-online", "WatchConfig", Type::Bool, "true", "",
+     "Picks up changes to this file while the launcher is running, so you don't have to restart it after editing.\n"
+     "The appID, executable and arguments are used from the next launch on, logging changes apply straight away."},
+    {Key::PipelinedLaunch, "uc-online", "PipelinedLaunch", Type::Bool, "false", "",
+     "Starts the game (paused) while Steam is still starting up and lets it run the moment Steam is ready, instead of one after the other.\n"
+     "Gets the game window up a little sooner. If Steam doesn't start, the paused game is closed again before it ever runs."},
+    {Key::CallbackRateHz, "uc-online", "CallbackRateHz", Type::UInt32, "30", "",
+     "How often Steam's callbacks are run while the launcher is open, per second. When nothing is coming in it slows down\n"
+     "step by step to once every CallbackIdleMaxMs, and speeds right back up when something does. Slowing down needs\n"
+     "ManualCallbackDispatch, SteamAPI_RunCallbacks doesn't say whether anything came in."},
+    {Key::CallbackIdleMaxMs, "uc-online", "CallbackIdleMaxMs", Type::UInt32, "100", "", ""},
+    {Key::ManualCallbackDispatch, "uc-online", "ManualCallbackDispatch", Type::Bool, "false", "",
+     "Hands Steam's callbacks out through the launcher's own table instead of SteamAPI_RunCallbacks. Lets the callback\n"
+     "rate back off while idle, it's not measurably faster per callback. Needs a steam_api that supports manual dispatch\n"
+     "(falls back to the normal way if it doesn't)."},
+    {Key::ExitTimeoutSeconds, "uc-online", "ExitTimeoutSeconds", Type::UInt32, "0", "",
+     "The launcher stays open until the game exits (or you press Ctrl+C). Set this to close it after that many seconds instead, 0 waits for the game."},
+
+    {Key::EnableLogging, "Logging", "EnableLogging", Type::Bool, "false", "",
+     "Turns on logging. Not much gets logged, so it's not exactly useful. I recommend keeping it set to false, however with it being rewritten, it seems to behave differently.\n"
+     "It doesn't give you a chance to see what the issue was if you set something incorrectly, it just closes immediately or runs for a second and then closes.\n"
+     "If you need it, set it to true. Otherwise, there's nothing really worth logging."},
+    {Key::LogFile, "Logging", "LogFile", Type::Path, "uc_online.log", "", ""},
+    {Key::LogLevel, "Logging", "LogLevel", Type::Choice, "info", "debug|info|warning|error",
+     "How chatty the log is: debug, info, warning or error."},
+    {Key::MaxLogSizeKB, "Logging", "MaxLogSizeKB", Type::UInt32, "0", "",
+     "Log rotation. Once the log is bigger than MaxLogSizeKB or older than MaxLogAgeHours it gets moved aside and a new one is started.\n"
+     "0 turns that limit off (the default, the log just keeps growing). RetainedLogs is how many old logs to keep around,\n"
+     "and CompressRotatedLogs gzips them in the background so they don't take much space."},
+    {Key::MaxLogAgeHours, "Logging", "MaxLogAgeHours", Type::UInt32, "0", "", ""},
+    {Key::RetainedLogs, "Logging", "RetainedLogs", Type::UInt32, "5", "", ""},
+    {Key::CompressRotatedLogs, "Logging", "CompressRotatedLogs", Type::Bool, "true", "", ""},
+    {Key::FlushPolicy, "Logging", "FlushPolicy", Type::Choice, "line", "line|bytes|interval|error",
+     "The log file stays open while the launcher runs. FlushPolicy decides when lines actually hit the disk:\n"
+     "line (after every line), bytes (once FlushBytes are waiting), interval (every FlushIntervalMs) or error (only on errors and on exit).\n"
+     "Anything other than line can lose the last few lines if the launcher crashes."},
+    {Key::FlushBytes, "Logging", "FlushBytes", Type::UInt32, "4096", "", ""},
+    {Key::FlushIntervalMs, "Logging", "FlushIntervalMs", Type::UInt32, "1000", "", ""},
+    {Key::WriteBufferSize, "Logging", "WriteBufferSize", Type::UInt32, "8192", "", ""},
+    {Key::TimestampPrecision, "Logging", "TimestampPrecision", Type::Choice, "seconds", "seconds|milliseconds|microseconds",
+     "Timestamps on each line. TimestampPrecision can be seconds, milliseconds or microseconds.\n"
+     "TimestampClock = monotonic keeps the times from jumping around if the system clock changes, handy for timing startup."},
+    {Key::TimestampClock, "Logging", "TimestampClock", Type::Choice, "system", "system|monotonic", ""},
+    {Key::Sinks, "Logging", "Sinks", Type::String, "text", "",
+     "Where log lines go, comma separated: text (LogFile), json (one JSON object per line in JsonLogFile)\n"
+     "and binary (compact records in BinaryLogFile, read it back with uc-online-logcat)."},
+    {Key::JsonLogFile, "Logging", "JsonLogFile", Type::Path, "uc_online.jsonl", "", ""},
+    {Key::BinaryLogFile, "Logging", "BinaryLogFile", Type::Path, "uc_online.ulog", "", ""},
+    {Key::AsyncLogging, "Logging", "AsyncLogging", Type::Bool, "false", "",
+     "Writes the log from a background thread instead of the launcher's own thread. Only matters if logging is on.\n"
+     "AsyncQueueSize is how many lines can be waiting at once, AsyncOverflowPolicy decides what happens when it's full:\n"
+     "block (wait for room), drop-newest (skip the new line) or drop-oldest (throw away the oldest waiting line)."},
+    {Key::AsyncQueueSize, "Logging", "AsyncQueueSize", Type::UInt32, "4096", "", ""},
+    {Key::AsyncOverflowPolicy, "Logging", "AsyncOverflowPolicy", Type::Choice, "block", "block|drop-newest|drop-oldest", ""},
+
+    {Key::TraceStartup, "Tracing", "TraceStartup", Type::Bool, "false", "",
+     "Times each step of starting up (reading the config, loading Steam, each interface, starting the game) and prints a table when the launcher exits.\n"
+     "TraceFile gets a Chrome trace of the run (open it in chrome://tracing or ui.perfetto.dev), TraceStatsFile keeps\n"
+     "p50/p95/p99 per step over every traced run, per launcher version, so you can see if a new version got slower."},
+    {Key::TraceFile, "Tracing", "TraceFile", Type::Path, "uc_online_trace.json", "", ""},
+    {Key::TraceStatsFile, "Tracing", "TraceStatsFile", Type::Path, "uc_online_trace.stats", "", ""},
+};
+
+inline constexpr size_t kKeyCount = static_cast<size_t>(Key::Count);
+static_assert(std::size(kKeys) == kKeyCount, "every ConfigSchema::Key needs an entry in kKeys");
+
+constexpr const KeyInfo& Info(Key key) {
+    return kKeys[static_cast<size_t>(key)];
+}
+
+// Position of value in a '|' separated choice list, -1 if it isn't one of them
+constexpr int FindChoice(std::string_view choices, std::string_view value) {
+    int index = 0;
+    size_t start = 0;
+    while (start <= choices.size()) {
+        size_t end = choices.find('|', start);
+        if (end == std::string_view::npos) end = choices.size();
+        if (choices.substr(start, end - start) == value) return index;
+        start = end + 1;
+        index++;
+    }
+    return -1;
+}
+
+// Perfect hash over (section, name), built by hash and displace: each key's hash picks
+// one of kBucketCount buckets, and every bucket gets the smallest displacement that
+// lands all of its keys in free slots. Fullest buckets go first, and each try only
+// looks at one bucket's keys, so building it takes a few steps per key instead of a
+// search over the whole key set. A lookup is one hash, one mix and one compare.
+inline constexpr size_t kTableSize = 64;
+inline constexpr size_t kBucketCount = 32;
+inline constexpr uint8_t kEmptySlot = 0xFF;
+static_assert((kTableSize & (kTableSize - 1)) == 0 && (kBucketCount & (kBucketCount - 1)) == 0, "both have to be powers of two");
+static_assert(kKeyCount < kTableSize, "kTableSize has to grow with the schema");
+
+// FNV-1a, 64 bit
+constexpr uint64_t Hash(std::string_view section, std::string_view name) {
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : section) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+    }
+    hash = (hash ^ 0xFFu) * 1099511628211ull;
+    for (char c : name) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+    }
+    return hash;
+}
+
+constexpr size_t BucketOf(uint64_t hash) {
+    return static_cast<size_t>(hash >> 58) & (kBucketCount - 1);
+}
+
+// splitmix64's finalizer, so every displacement scatters a bucket's keys somewhere new
+constexpr size_t SlotOf(uint64_t hash, uint16_t displacement) {
+    uint64_t x = hash + (displacement + 1) * 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return static_cast<size_t>(x ^ (x >> 31)) & (kTableSize - 1);
+}
+
+struct PerfectHash {
+    std::array<uint16_t, kBucketCount> displacements{};
+    std::array<uint8_t, kTableSize> slots{};
+    // False for duplicate keys, nothing else makes a bucket impossible to place
+    bool valid = true;
+};
+
+constexpr PerfectHash BuildPerfectHash() {
+    PerfectHash table;
+    for (size_t i = 0; i < kTableSize; i++) table.slots[i] = kEmptySlot;
+
+    uint64_t hashes[kKeyCount] = {};
+    size_t bucketSizes[kBucketCount] = {};
+    for (size_t i = 0; i < kKeyCount; i++) {
+        hashes[i] = Hash(kKeys[i].section, kKeys[i].name);
+        bucketSizes[BucketOf(hashes[i])]++;
+        for (size_t j = 0; j < i; j++) {
+            // Same key twice (or a 64-bit collision), no displacement can split those
+            if (hashes[j] == hashes[i]) table.valid = false;
+        }
+    }
+    if (!table.valid) {
+        return table;
+    }
+
+    for (size_t size = kKeyCount; size > 0; size--) {
+        for (size_t bucket = 0; bucket < kBucketCount; bucket++) {
+            if (bucketSizes[bucket] != size) continue;
+
+            bool placed = false;
+            for (uint32_t displacement = 0; displacement <= 0xFFFF && !placed; displacement++) {
+                size_t slots[kKeyCount] = {};
+                size_t count = 0;
+                bool fits = true;
+                for (size_t i = 0; i < kKeyCount && fits; i++) {
+                    if (BucketOf(hashes[i]) != bucket) continue;
+                    size_t slot = SlotOf(hashes[i], static_cast<uint16_t>(displacement));
+                    fits = table.slots[slot] == kEmptySlot;
+                    for (size_t j = 0; j < count && fits; j++) {
+                        fits = slots[j] != slot;
+                    }
+                    slots[count++] = slot;
+                }
+                if (!fits) continue;
+
+                count = 0;
+                for (size_t i = 0; i < kKeyCount; i++) {
+                    if (BucketOf(hashes[i]) == bucket) {
+                        table.slots[slots[count++]] = static_cast<uint8_t>(i);
+                    }
+                }
+                table.displacements[bucket] = static_cast<uint16_t>(displacement);
+                placed = true;
+            }
+            table.valid = table.valid && placed;
+        }
+    }
+    return table;
+}
+
+inline constexpr PerfectHash kPerfectHash = BuildPerfectHash();
+static_assert(kPerfectHash.valid, "config keys don't hash apart, there is a duplicate key in kKeys");
+
+// Key::Count if section/name isn't part of the schema
+constexpr Key Find(std::string_view section, std::string_view name) {
+    uint64_t hash = Hash(section, name);
+    uint8_t index = kPerfectHash.slots[SlotOf(hash, kPerfectHash.displacements[BucketOf(hash)])];
+    if (index == kEmptySlot) return Key::Count;
+    const KeyInfo& info = kKeys[index];
+    return info.section == section && info.name == name ? info.id : Key::Count;
+}
+
+// For keys spelled out in code: constexpr Key key = KeyOf("Logging", "LogFile");
+// A misspelled name fails to compile instead of silently reading the default.
+constexpr Key KeyOf(std::string_view section, std::string_view name) {
+    Key key = Find(section, name);
+    if (key == Key::Count) {
+        throw std::invalid_argument("unknown config key");
+    }
+    return key;
+}
+
+constexpr bool IsValidDefault(const KeyInfo& info) {
+    switch (info.type) {
+        case Type::UInt32:
+            if (info.defaultValue.empty()) return false;
+            for (char c : info.defaultValue) {
+                if (c < '0' || c > '9') return false;
+            }
+            return true;
+        case Type::Bool:
+            return info.defaultValue == "true" || info.defaultValue == "false";
+        case Type::Choice:
+            return FindChoice(info.choices, info.defaultValue) >= 0;
+        default:
+            return true;
+    }
+}
+
+constexpr bool IsValidSchema() {
+    for (size_t i = 0; i < kKeyCount; i++) {
+        if (static_cast<size_t>(kKeys[i].id) != i) return false;
+        if (!IsValidDefault(kKeys[i])) return false;
+        if (Find(kKeys[i].section, kKeys[i].name) != kKeys[i].id) return false;
+        // Keys of a section have to sit together so the default file gets one header per section
+        for (size_t j = i + 2; j < kKeyCount; j++) {
+            if (kKeys[j].section == kKeys[i].section && kKeys[j - 1].section != kKeys[i].section) return false;
+        }
+    }
+    return true;
+}
+
+static_assert(IsValidSchema(), "kKeys is out of order with Key, has a bad default, splits a section or doesn't hash apart");
+
+// C++ type each key is stored as once parsed
+template <Type T> struct ValueOf;
+template <> struct ValueOf<Type::UInt32> { using Type = uint32_t; };
+template <> struct ValueOf<Type::Bool> { using Type = bool; };
+template <> struct ValueOf<Type::String> { using Type = std::string; };
+template <> struct ValueOf<Type::Path> { using Type = std::filesystem::path; };
+template <> struct ValueOf<Type::Choice> { using Type = uint8_t; };
+
+template <Key K>
+using ValueType = typename ValueOf<Info(K).type>::Type;
+
+// The text CreateDefaultConfig writes, generated from kKeys
+std::string DefaultConfigText();
+
+} // namespace ConfigSchema
+
+using ConfigKey = ConfigSchema::Key;
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "file_watcher.hpp"
+#include "ini_config.hpp"
+
+// Follows config.ini on disk and publishes a fresh read-only snapshot whenever its
+// content actually changes (saves that write the same bytes back are ignored).
+// Snapshots are immutable, so any thread can hold on to one while a newer one is published.
+class ConfigWatcher {
+public:
+    // Runs on the watcher thread right after a new snapshot is published
+    using Listener = std::function<void(const IniConfig& config)>;
+
+    explicit ConfigWatcher(const std::string& iniFilePath);
+    ~ConfigWatcher();
+
+    ConfigWatcher(const ConfigWatcher&) = delete;
+    ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+    std::shared_ptr<const IniConfig> GetSnapshot() const;
+    // Goes up by one for every published snapshot, cheap way to notice a change without taking one
+    uint64_t GetVersion() const;
+    void Subscribe(Listener listener);
+    bool IsWatching() const;
+
+private:
+    std::string _iniFilePath;
+    std::shared_ptr<const IniConfig> _snapshot;
+    std::atomic<uint64_t> _version{0};
+    uint64_t _contentHash = 0;
+    std::mutex _listenersLock;
+    std::vector<Listener> _listeners;
+    // Last so it stops before anything above goes away
+    std::unique_ptr<FileWatcher> _watcher;
+    void Reload();
+};
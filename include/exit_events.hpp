@@ -0,0 +1,62 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+// Why the launcher stopped waiting
+enum class ExitReason {
+    None,
+    GameExited,
+    Timeout,
+    Signal, // Ctrl+C, closing the console window, SIGTERM / SIGHUP
+    Requested
+};
+
+const char* ExitReasonName(ExitReason reason);
+
+// Everything that can end the launcher's run, so main() blocks on one thing instead of
+// counting sleeps. Signals arrive through a console control handler on Windows and a
+// self-pipe everywhere else. A watched process is waited on by its own thread on
+// Windows and picked up from SIGCHLD everywhere else. Nothing polls.
+class ExitEvents {
+public:
+    ExitEvents();
+    // Puts the previous signal handlers back
+    ~ExitEvents();
+
+    ExitEvents(const ExitEvents&) = delete;
+    ExitEvents& operator=(const ExitEvents&) = delete;
+
+    // Only one ExitEvents can have the signals at a time, false if another one does or setup failed
+    bool ListenForSignals();
+    // GameExited once processId (a child of ours) is gone, straight away if it already is
+    bool WatchProcess(uint32_t processId);
+    // Everything after the wait is done. Closing the console window (or logging off) on
+    // Windows holds the process up for this, for a few seconds at most
+    void ShutdownComplete();
+
+    // The first reason is the one that sticks
+    void Notify(ExitReason reason);
+    // Ends the current (or next) Wait() early with ExitReason::None, without a reason of its
+    // own. For work that has to happen on the waiting thread
+    void Wake();
+    // Blocks until something happened, Wake() or for timeout (zero = no limit)
+    ExitReason Wait(std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+    // Like Wait(), but running out of time isn't a reason to exit, that's ExitReason::None
+    // too. For a waiting thread with something of its own to do every so often
+    ExitReason WaitAtMost(std::chrono::milliseconds timeout);
+    ExitReason GetReason() const;
+
+    // Platform side, lives in exit_events.cpp
+    class Backend;
+
+private:
+    mutable std::mutex _mutex;
+    std::condition_variable _condition;
+    ExitReason _reason = ExitReason::None;
+    bool _woken = false;
+    std::unique_ptr<Backend> _backend;
+};
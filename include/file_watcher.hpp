@@ -0,0 +1,39 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+// Watches a single file from its own thread and calls onChange once a burst of
+// writes has gone quiet for the debounce interval. Uses inotify on Linux and
+// directory change notifications on Windows, anything else falls back to polling
+// the modification time. onChange runs on the watcher thread.
+//
+// The parent directory is watched rather than the file itself, so a file that is
+// replaced by a rename (like config.ini saves) keeps being followed.
+class FileWatcher {
+public:
+    FileWatcher(const std::string& path, std::function<void()> onChange,
+                std::chrono::milliseconds debounce = std::chrono::milliseconds(250));
+    // Stops the thread, a pending debounced change is dropped
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // False if the platform watch couldn't be set up, nothing will be reported in that case
+    bool IsWatching() const;
+
+    // Platform side, lives in file_watcher.cpp
+    class Backend;
+
+private:
+    std::unique_ptr<Backend> _backend;
+    std::function<void()> _onChange;
+    std::chrono::milliseconds _debounce;
+    std::thread _thread;
+    void Run();
+};
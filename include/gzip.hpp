@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Minimal gzip encoder for rotated logs, so we don't need to ship zlib.
+// Uses LZ77 with the fixed DEFLATE Huffman tables: not as tight as zlib,
+// but log text still shrinks a lot and any gzip tool can read the result.
+class Gzip {
+public:
+    static std::vector<uint8_t> Compress(const uint8_t* data, size_t size);
+    // Writes source compressed to destination, returns false on any I/O error
+    static bool CompressFile(const std::string& sourcePath, const std::string& destinationPath);
+};
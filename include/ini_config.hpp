@@ -1,30 +1,125 @@
 #pragma once
 
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <cstdint>
 #include <filesystem>
+#include <memory>
 #include "path_utils.hpp"
+#include "atomic_file.hpp"
+#include "launcher_settings.hpp"
 
 class IniConfig {
+    friend class ConfigTransaction;
+
 public:
-    IniConfig(const std::string& iniFilePath = "config.ini");
+    // writer decides how the file is replaced on save, AtomicFileWriter::Default() if null
+    IniConfig(const std::string& iniFilePath = "config.ini", std::shared_ptr<FileWriter> writer = nullptr);
+    // Parses contents that were already read from iniFilePath instead of reading it again
+    IniConfig(const std::string& iniFilePath, std::string contents, std::shared_ptr<FileWriter> writer = nullptr);
+
+    // Entries point into our own buffer, a plain copy would leave them pointing into the original
+    IniConfig(const IniConfig&) = delete;
+    IniConfig& operator=(const IniConfig&) = delete;
+
     void LoadConfig();
+    // Writes the file back with comments and ordering intact, does nothing if no value changed.
+    // Inside a ConfigTransaction the write is deferred until the outermost one commits.
+    // Saves hold <config>.lock and replay our changes on top of whatever another launcher saved meanwhile.
     void SaveConfig();
-    std::string GetValue(const std::string& section, const std::string& key, const std::string& defaultValue = "") const;
-    void SetValue(const std::string& section, const std::string& key, const std::string& value);
+    std::string GetValue(std::string_view section, std::string_view key, std::string_view defaultValue = "") const;
+    // Same lookup without copying. The view stays valid until the next LoadConfig() or SaveConfig()
+    std::string_view GetValueView(std::string_view section, std::string_view key, std::string_view defaultValue = "") const;
+    // True if the key is actually in the file, GetValue can't tell that apart from an empty value
+    bool HasValue(std::string_view section, std::string_view key) const;
+    const std::string& GetFilePath() const;
+    void SetValue(std::string_view section, std::string_view key, std::string_view value);
+    void SetValue(ConfigKey key, std::string_view value);
+
+    // Every schema key already converted to its real type, kept up to date by SetValue
+    const LauncherSettings& GetSettings() const;
 
     // Specific getters/setters
-    uint32_t GetAppID();
+    uint32_t GetAppID() const;
     void SetAppID(uint32_t appId);
-    std::string GetGameExecutable();
+    std::string GetGameExecutable() const;
     void SetGameExecutable(const std::string& gameExePath);
-    std::string GetGameArguments();
+    std::string GetGameArguments() const;
     void SetGameArguments(const std::string& arguments);
-    std::string GetSteamApiDllPath();
+    std::string GetSteamApiDllPath() const;
     void SetSteamApiDllPath(const std::string& dllPath);
 
 private:
+    static constexpr size_t kNotFound = static_cast<size_t>(-1);
+
+    struct Entry {
+        std::string_view section;
+        std::string_view key;
+        std::string_view value;
+        size_t line = kNotFound;  // line the key was read from, kNotFound if added by SetValue
+        size_t valueOffset = 0;   // where the value starts within that line
+        bool dirty = false;
+    };
+
+    struct Section {
+        std::string_view name;
+        size_t lastLine = kNotFound; // header or last key line, new keys go right after it
+    };
+
     std::string _iniFilePath;
-    std::unordered_map<std::string, std::unordered_map<std::string, std::string>> _configData;
+    std::shared_ptr<FileWriter> _writer;
+    // The whole file as read from disk, parsed lines and entries point straight into it
+    std::string _buffer;
+    // Every line of the file, comments and blanks included, so saving can keep them
+    std::vector<std::string_view> _lines;
+    bool _crlf = false;
+    bool _dirty = false;
+    int _transactionDepth = 0;
+    // Anything added by SetValue, a deque so earlier views never move
+    std::deque<std::string> _ownedStrings;
+    // Entries and sections in file order
+    std::vector<Entry> _entries;
+    std::vector<Section> _sections;
+    // Open addressing table over _entries, each slot holds index + 1 (0 = empty)
+    std::vector<uint32_t> _slots;
+    // Filled in while parsing, each known key is converted as its line is read
+    LauncherSettings _settings;
+
     void CreateDefaultConfig();
+    bool ReadFile(std::string& contents) const;
+
+    void Parse();
+    void Clear();
+    size_t Find(std::string_view section, std::string_view key) const;
+    size_t Insert(std::string_view section, std::string_view key, std::string_view value);
+    Section& AddSection(std::string_view section);
+    std::string Render() const;
+    void Rehash(size_t slotCount);
+    std::string_view Own(std::string_view text);
+    static size_t Hash(std::string_view section, std::string_view key);
+};
+
+// Collapses any number of Set* calls into one SaveConfig when the outermost
+// transaction commits (explicitly or when it goes out of scope):
+//
+//     ConfigTransaction transaction(config);
+//     config.SetAppID(730);
+//     config.SetGameExecutable(path);
+//     // written once here
+class ConfigTransaction {
+public:
+    explicit ConfigTransaction(IniConfig& config);
+    ConfigTransaction(ConfigTransaction&& other) noexcept;
+    ~ConfigTransaction();
+
+    ConfigTransaction(const ConfigTransaction&) = delete;
+    ConfigTransaction& operator=(const ConfigTransaction&) = delete;
+    ConfigTransaction& operator=(ConfigTransaction&&) = delete;
+
+    void Commit();
+
+private:
+    IniConfig* _config;
 };
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "config_schema.hpp"
+
+// Every key in ConfigSchema, converted to its real type as the config is parsed.
+// Reading one is a plain member access, e.g. settings.Get<ConfigKey::AppID>(),
+// and asking for a key that doesn't exist is a build error.
+class LauncherSettings {
+public:
+    // Every key starts out at its schema default
+    LauncherSettings();
+
+    template <ConfigKey K>
+    const ConfigSchema::ValueType<K>& Get() const {
+        return std::get<static_cast<size_t>(K)>(_values);
+    }
+
+    // Converts value into the slot for section/key, false for keys the schema doesn't know.
+    // A value that doesn't convert is reported in GetErrors() and leaves the slot as it was.
+    bool Apply(std::string_view section, std::string_view key, std::string_view value);
+    // Same for a key known at compile time, false if the value didn't convert or was left
+    // empty for a non-string key (the slot keeps what it had then)
+    bool Apply(ConfigKey key, std::string_view value);
+
+    // One message per value that couldn't be converted
+    const std::vector<std::string>& GetErrors() const { return _errors; }
+
+private:
+    template <size_t... I>
+    static std::tuple<ConfigSchema::ValueType<static_cast<ConfigKey>(I)>...> MakeValues(std::index_sequence<I...>);
+    using Values = decltype(MakeValues(std::make_index_sequence<ConfigSchema::kKeyCount>()));
+
+    Values _values;
+    std::vector<std::string> _errors;
+
+    // One converter per key, Apply() jumps straight to the right one
+    using Converter = bool (*)(LauncherSettings& settings, std::string_view value);
+    template <size_t I>
+    static bool Convert(LauncherSettings& settings, std::string_view value);
+    template <size_t... I>
+    static constexpr std::array<Converter, sizeof...(I)> MakeConverters(std::index_sequence<I...>);
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+// Everything that differs between the 32 and 64-bit launcher. UCOnlineLauncher takes
+// one of these as a template argument, so the difference is settled at compile time
+// and nothing in the launcher ever checks which one it is.
+struct Launcher32Traits {
+    // Used in log lines and the console banner
+    static constexpr const char* kName = "uc-online";
+    static constexpr const char* kArchitecture = "32-bit";
+    // File name of the Steam API library, looked for in SteamApiDLLPath
+#ifdef _WIN32
+    static constexpr const char* kSteamApiLibrary = "steam_api.dll";
+#else
+    static constexpr const char* kSteamApiLibrary = "libsteam_api.so";
+#endif
+};
+
+struct Launcher64Traits {
+    static constexpr const char* kName = "uc-online64";
+    static constexpr const char* kArchitecture = "64-bit";
+#ifdef _WIN32
+    static constexpr const char* kSteamApiLibrary = "steam_api64.dll";
+#else
+    static constexpr const char* kSteamApiLibrary = "libsteam_api.so";
+#endif
+};
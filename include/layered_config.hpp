@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "config_schema.hpp"
+#include "ini_config.hpp"
+#include "launcher_settings.hpp"
+
+// Where a resolved value came from, later layers win
+enum class ConfigLayer : uint8_t {
+    Default,     // ConfigSchema default
+    Machine,     // machine-wide ini, see LayeredConfig::MachineConfigPath()
+    Game,        // the launcher's own config.ini (or the one picked with --config)
+    Environment, // UC_ONLINE_<KEY> variables, e.g. UC_ONLINE_APPID=730
+    CommandLine  // --<key>=<value> flags, e.g. --appid=730
+};
+
+const char* ConfigLayerName(ConfigLayer layer);
+
+// Values from the environment or the command line, already matched to schema keys
+struct ConfigOverrides {
+    struct Value {
+        ConfigKey key;
+        std::string value;
+    };
+    std::vector<Value> values;
+    // --config=<path> / UC_ONLINE_CONFIG, which per-game ini to use instead of config.ini
+    std::string configPath;
+    // Flags that didn't match any key, so main() can complain about them
+    std::vector<std::string> unknown;
+
+    // UC_ONLINE_ plus the key name in capitals, e.g. UC_ONLINE_LOGFILE
+    static ConfigOverrides FromEnvironment();
+    // --AppID=730 or --appid 730, key names are not case sensitive
+    static ConfigOverrides FromCommandLine(int argc, char** argv);
+};
+
+// Every layer merged into one flat, read-only set of settings. The merge happens
+// once in the constructor, afterwards a lookup is the same member access as on
+// LauncherSettings and knows nothing about layers. An ini value that is empty or
+// the schema default doesn't override the layer below it (config.ini is generated
+// with every default written out), the environment or command line can.
+class LayeredConfig {
+public:
+    // machine may be null when there is no machine-wide ini
+    LayeredConfig(const IniConfig* machine, const IniConfig& game, const ConfigOverrides& environment,
+                  const ConfigOverrides& commandLine);
+
+    const LauncherSettings& GetSettings() const { return _settings; }
+    ConfigLayer GetSource(ConfigKey key) const { return _sources[static_cast<size_t>(key)]; }
+    // True when the value comes from the environment or the command line rather than an ini
+    bool IsOverridden(ConfigKey key) const { return GetSource(key) >= ConfigLayer::Environment; }
+
+    // UC_ONLINE_MACHINE_CONFIG if set, otherwise %ProgramData%\uc-online\config.ini
+    // on Windows and /etc/uc-online/config.ini elsewhere
+    static std::string MachineConfigPath();
+    // Parses the machine-wide ini if there is one. Never creates it, it's only ever read.
+    static std::unique_ptr<IniConfig> LoadMachineConfig();
+
+private:
+    LauncherSettings _settings;
+    ConfigLayer _sources[ConfigSchema::kKeyCount];
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Background side of log rotation. The logger only renames the full log to
+// NextRotatedPath() and hands it over; compression and deleting generations
+// beyond the retention limit happen here on a separate thread.
+//
+// Rotated logs are named <stem>.<YYYYmmdd-HHMMSS-mmm><ext>[.gz] next to the
+// live log, so they sort oldest to newest by name.
+class LogArchiver {
+public:
+    LogArchiver(const std::string& logFilePath, size_t retainedFiles, bool compress);
+    // Finishes any queued compression before returning
+    ~LogArchiver();
+
+    LogArchiver(const LogArchiver&) = delete;
+    LogArchiver& operator=(const LogArchiver&) = delete;
+
+    std::string NextRotatedPath() const;
+    void Submit(const std::string& rotatedPath);
+
+private:
+    std::filesystem::path _directory;
+    std::string _stem;
+    std::string _extension;
+    size_t _retainedFiles;
+    bool _compress;
+
+    std::thread _thread;
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::deque<std::string> _jobs;
+    bool _stop = false;
+
+    void Run();
+    void Compress(const std::filesystem::path& rotatedPath);
+    void CompressLeftovers();
+    void Prune();
+    bool IsRotatedName(const std::string& fileName, bool& compressed) const;
+};
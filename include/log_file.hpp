@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Append-only log file that stays open for the lifetime of the logger.
+// Lines are collected in an owned buffer and only handed to the OS on Flush()
+// or when the buffer fills up, so logging a line is normally just a memcpy.
+class LogFile {
+public:
+    explicit LogFile(size_t bufferSize = 8192);
+    ~LogFile();
+
+    LogFile(const LogFile&) = delete;
+    LogFile& operator=(const LogFile&) = delete;
+
+    bool Open(const std::string& path);
+    bool IsOpen() const;
+    void Close();
+
+    bool Append(const char* data, size_t size);
+    bool Append(const std::string& text);
+    // Hands everything buffered to the OS
+    bool Flush();
+    // Drops anything buffered and truncates the file through the same handle
+    bool Truncate();
+    size_t PendingBytes() const;
+
+private:
+    std::FILE* _file = nullptr;
+    std::vector<char> _buffer;
+    size_t _used = 0;
+    bool WriteThrough(const char* data, size_t size);
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <charconv>
+#include <exception>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Appends log message pieces to a string without going through iostreams.
+// Used by Logger's variadic Info/Warning/Error/Debug so a message is only
+// built once the logger has decided the line will actually be written.
+namespace LogFormat {
+    inline void Append(std::string& out, std::string_view value) {
+        out.append(value.data(), value.size());
+    }
+
+    inline void Append(std::string& out, const std::string& value) {
+        out.append(value);
+    }
+
+    inline void Append(std::string& out, const char* value) {
+        out.append(value ? value : "(null)");
+    }
+
+    inline void Append(std::string& out, char value) {
+        out.push_back(value);
+    }
+
+    inline void Append(std::string& out, bool value) {
+        out.append(value ? "true" : "false");
+    }
+
+    inline void Append(std::string& out, const std::exception& ex) {
+        out.append(ex.what());
+    }
+
+    template <typename T>
+    std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>>
+    Append(std::string& out, T value) {
+        char buffer[24];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.append(buffer, result.ptr);
+    }
+
+    template <typename T>
+    std::enable_if_t<std::is_floating_point_v<T>>
+    Append(std::string& out, T value) {
+        out.append(std::to_string(value));
+    }
+
+    template <typename T>
+    std::enable_if_t<std::is_enum_v<T>>
+    Append(std::string& out, T value) {
+        Append(out, static_cast<std::underlying_type_t<T>>(value));
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Lowest level that gets compiled in at all (0 = DEBUG, 1 = INFO, 2 = WARNING, 3 = ERROR).
+// Calls below it turn into nothing, see the UC_ONLINE_MIN_LOG_LEVEL cache entry in CMakeLists.txt.
+#ifndef UC_ONLINE_MIN_LOG_LEVEL
+#define UC_ONLINE_MIN_LOG_LEVEL 0
+#endif
+
+enum class LogLevel {
+    Debug,
+    Info,
+    Warning,
+    Error,
+    Exception,
+    Off // threshold only, never written
+};
+
+constexpr bool IsLogLevelCompiledIn(LogLevel level) {
+    return static_cast<int>(level) >= UC_ONLINE_MIN_LOG_LEVEL;
+}
+
+inline const char* LogLevelName(LogLevel level) {
+    static const char* const names[] = { "DEBUG", "INFO", "WARNING", "ERROR", "EXCEPTION", "OFF" };
+    return names[static_cast<int>(level)];
+}
+
+// One log line before formatting. Producers only capture the raw fields,
+// the text and any other sinks are formatted from it later.
+struct LogRecord {
+    std::chrono::system_clock::time_point time;
+    uint64_t monotonicNs = 0; // steady clock, relative to the logger's start
+    uint64_t threadId = 0;
+    LogLevel level = LogLevel::Info;
+    const char* source = "";
+    std::string message;
+};
+
+// Tags every line logged on this thread with a source while in scope, e.g.
+//     LogSourceScope source("InitializeSteamGameServer");
+// The tag has to be a string literal, the async writer only keeps the pointer.
+class LogSourceScope {
+public:
+    explicit LogSourceScope(const char* source) : _previous(Current()) {
+        Current() = source;
+    }
+
+    ~LogSourceScope() {
+        Current() = _previous;
+    }
+
+    LogSourceScope(const LogSourceScope&) = delete;
+    LogSourceScope& operator=(const LogSourceScope&) = delete;
+
+    static const char*& Current() {
+        thread_local const char* source = "";
+        return source;
+    }
+
+private:
+    const char* _previous;
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+// Bounded lock-free ring buffer used by the async logger.
+// Any number of threads can push, any number can pop (the logger has one writer
+// thread, but producers also pop when dropping the oldest record on overflow).
+// Each slot carries a sequence number so producers and consumers never need a lock.
+template <typename T>
+class LogRingBuffer {
+public:
+    explicit LogRingBuffer(size_t capacity)
+        : _capacity(RoundUpToPowerOfTwo(capacity < 2 ? 2 : capacity)),
+          _mask(_capacity - 1),
+          _slots(new Slot[_capacity]) {
+        for (size_t i = 0; i < _capacity; i++) {
+            _slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    LogRingBuffer(const LogRingBuffer&) = delete;
+    LogRingBuffer& operator=(const LogRingBuffer&) = delete;
+
+    // Returns false when the buffer is full, value is left untouched in that case
+    bool TryPush(T& value) {
+        size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = _slots[pos & _mask];
+            size_t seq = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.value = std::move(value);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = _enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Returns false when the buffer is empty
+    bool TryPop(T& value) {
+        size_t pos = _dequeuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = _slots[pos & _mask];
+            size_t seq = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = std::move(slot.value);
+                    slot.sequence.store(pos + _mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = _dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Monotonic positions, used by the logger to know how far the writer has drained
+    size_t EnqueuePosition() const { return _enqueuePos.load(std::memory_order_acquire); }
+    size_t DequeuePosition() const { return _dequeuePos.load(std::memory_order_acquire); }
+    size_t Capacity() const { return _capacity; }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    static size_t RoundUpToPowerOfTwo(size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    const size_t _capacity;
+    const size_t _mask;
+    std::unique_ptr<Slot[]> _slots;
+    // Keep the two cursors on separate cache lines so producers and the writer don't fight over them
+    alignas(64) std::atomic<size_t> _enqueuePos{0};
+    alignas(64) std::atomic<size_t> _dequeuePos{0};
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include "log_file.hpp"
+#include "log_record.hpp"
+
+// Extra outputs next to the plain text log. The logger formats each record's
+// message and timestamp once and hands the same record to every sink.
+// Sinks are only called while the logger holds its lock. Each one is a file of its
+// own, opened on the first write, which the logger rotates like the text log.
+class LogSink {
+public:
+    LogSink(const std::string& path, size_t bufferSize);
+    virtual ~LogSink() = default;
+
+    LogSink(const LogSink&) = delete;
+    LogSink& operator=(const LogSink&) = delete;
+
+    virtual void Write(const LogRecord& record, std::string_view timestamp) = 0;
+    void Flush();
+    // For rotation: the file can be renamed away after this, the next Write starts a new one
+    void Close();
+
+    const std::string& GetPath() const { return _path; }
+    // Bytes in the file, buffered ones included. After a Close() whatever was already
+    // in a reopened file isn't counted, same as the text log after a failed rotation
+    uint64_t GetSize() const { return _size; }
+    // When the file was started, or opened if it was there already
+    std::chrono::system_clock::time_point GetStarted() const { return _started; }
+
+protected:
+    // Opens the file first if needed
+    bool Append(const std::string& data);
+    // Right after the file was opened, isNew if it was empty. Anything Append()ed here
+    // comes before the first record
+    virtual void OnOpen(bool /*isNew*/) {}
+
+private:
+    std::string _path;
+    LogFile _file;
+    uint64_t _size = 0;
+    std::chrono::system_clock::time_point _started;
+    bool _closed = false;
+    bool _reportedError = false;
+};
+
+// One JSON object per line, for scripts that want to ingest the log
+class JsonLinesLogSink : public LogSink {
+public:
+    JsonLinesLogSink(const std::string& path, size_t bufferSize);
+    void Write(const LogRecord& record, std::string_view timestamp) override;
+
+private:
+    std::string _line;
+};
+
+// Compact length-prefixed records, see binary_log_format.hpp for the layout
+class BinaryLogSink : public LogSink {
+public:
+    BinaryLogSink(const std::string& path, size_t bufferSize, std::chrono::system_clock::time_point sessionStart);
+    void Write(const LogRecord& record, std::string_view timestamp) override;
+
+protected:
+    // Magic for a new file, and a session entry at the start of every file so a rotated
+    // one can be read on its own
+    void OnOpen(bool isNew) override;
+
+private:
+    std::chrono::system_clock::time_point _sessionStart;
+    std::string _entry;
+};
@@ -3,24 +3,173 @@
 #include <string>
 #include <mutex>
 #include <chrono>
-#include <iomanip>
-#include <sstream>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <thread>
+#include <vector>
 #include "path_utils.hpp"
+#include "log_ring_buffer.hpp"
+#include "log_file.hpp"
+#include "timestamp_formatter.hpp"
+#include "log_format.hpp"
+#include "log_archiver.hpp"
+#include "log_record.hpp"
+#include "log_sink.hpp"
+
+class IniConfig;
+class LauncherSettings;
+
+// What to do when the async queue is full
+enum class LogOverflowPolicy {
+    Block,      // wait for the writer thread to make room
+    DropNewest, // discard the line being logged
+    DropOldest  // discard the oldest queued line to make room
+};
+
+// When buffered lines are handed to the OS
+enum class LogFlushPolicy {
+    EveryLine, // after every line (safest, the old behaviour)
+    Bytes,     // once flushBytes are buffered
+    Interval,  // when flushIntervalMs have passed since the last flush
+    OnError    // only when an ERROR or EXCEPTION line is logged (and on shutdown)
+};
+
+struct LoggerOptions {
+    LogLevel minLevel = LogLevel::Info;
+
+    LogFlushPolicy flushPolicy = LogFlushPolicy::EveryLine;
+    size_t flushBytes = 4096;
+    uint32_t flushIntervalMs = 1000;
+    size_t writeBufferSize = 8192;
+
+    TimestampPrecision timestampPrecision = TimestampPrecision::Seconds;
+    TimestampClock timestampClock = TimestampClock::System;
+
+    // Rotation, 0 turns the respective limit off
+    uint64_t maxFileSize = 0;
+    uint32_t maxFileAgeHours = 0;
+    size_t retainedLogs = 5;
+    bool compressRotatedLogs = true;
+
+    // Outputs, any combination can be on at once
+    bool textSink = true;
+    bool jsonSink = false;
+    bool binarySink = false;
+    std::string jsonLogFile = "uc_online.jsonl";
+    std::string binaryLogFile = "uc_online.ulog";
+
+    bool asyncLogging = false;
+    size_t asyncQueueSize = 4096;
+    LogOverflowPolicy overflowPolicy = LogOverflowPolicy::Block;
+
+    // Reads the [Logging] section, anything missing or invalid keeps its default
+    static LoggerOptions FromConfig(const IniConfig& config);
+    static LoggerOptions FromSettings(const LauncherSettings& settings);
+};
 
 class Logger {
 public:
-    Logger(const std::string& logFilePath, bool enableLogging);
+    Logger(const std::string& logFilePath, bool enableLogging, const LoggerOptions& options = LoggerOptions());
+    ~Logger();
     void SetLoggingEnabled(bool enabled);
     bool IsLoggingEnabledA() const;
+    // Switches the text log to another file, lines already logged stay in the old one
+    void SetLogFilePath(const std::string& logFilePath);
+    std::string GetLogFilePath();
     void Log(const std::string& message);
     void LogWarning(const std::string& message);
     void LogError(const std::string& message);
     void LogException(const std::exception& ex, const std::string& context = "");
     void ClearLog();
 
+    // True when a line at this level would be written. Cheap enough to call before doing any work.
+    bool ShouldLog(LogLevel level) const {
+        return static_cast<int>(level) >= _threshold.load(std::memory_order_relaxed);
+    }
+
+    // Variadic logging, e.g. Info("Appid changed to: ", appID).
+    // The arguments are only formatted when the line is going to be written.
+    template <typename... Args> void Debug(const Args&... args) { Emit<LogLevel::Debug>(args...); }
+    template <typename... Args> void Info(const Args&... args) { Emit<LogLevel::Info>(args...); }
+    template <typename... Args> void Warning(const Args&... args) { Emit<LogLevel::Warning>(args...); }
+    template <typename... Args> void Error(const Args&... args) { Emit<LogLevel::Error>(args...); }
+
+    // Blocks until everything logged before this call has been written to disk
+    void Flush();
+    // Interval flush policy: flushes once flushIntervalMs have passed since the last flush.
+    // Otherwise that's only checked when a line is logged, and the last lines before
+    // things go quiet would sit in the buffer, so call this every GetFlushInterval()
+    void FlushIfDue();
+    // How often FlushIfDue() wants calling, zero unless the flush policy is Interval
+    std::chrono::milliseconds GetFlushInterval() const;
+    // Number of lines discarded by the async overflow policy
+    uint64_t GetDroppedCount() const;
+
 private:
     std::string _logFilePath;
-    bool _loggingEnabled;
+    std::atomic<bool> _loggingEnabled;
+    // Lowest level currently written, LogLevel::Off while logging is disabled
+    std::atomic<int> _threshold;
     std::mutex _lock;
-    std::string GetCurrentTimeString() const;
-};
\ No newline at end of file
+    void Write(LogLevel level, const std::string& message);
+    void UpdateThreshold();
+
+    template <LogLevel Level, typename... Args>
+    void Emit(const Args&... args) {
+        if constexpr (IsLogLevelCompiledIn(Level)) {
+            if (!ShouldLog(Level)) return;
+            thread_local std::string message;
+            message.clear();
+            (LogFormat::Append(message, args), ...);
+            Write(Level, message);
+        }
+    }
+
+    // The log file, timestamp cache, sinks and line buffer are guarded by _lock
+    LogFile _file;
+    TimestampFormatter _timestamp;
+    std::chrono::steady_clock::time_point _started;
+    std::string _lineBuffer;
+    LogRecord _syncRecord;
+    // Each sink with the archiver for its rotated files, null without rotation
+    struct SinkOutput {
+        std::unique_ptr<LogSink> sink;
+        std::unique_ptr<LogArchiver> archiver;
+    };
+    std::vector<SinkOutput> _sinks;
+    bool _sinksOpened = false;
+    void FormatRecord(const LogRecord& record);
+    void WriteFormatted(bool flush);
+    void FlushAll();
+    std::chrono::steady_clock::time_point _lastFlush;
+    bool EnsureFileOpen();
+    bool OpenFile();
+    bool ShouldFlush(LogLevel level) const;
+
+    // Rotation, also guarded by _lock
+    std::unique_ptr<LogArchiver> _archiver;
+    uint64_t _fileSize = 0;
+    std::chrono::system_clock::time_point _fileStarted;
+    void RotateIfNeeded();
+    bool IsRotationDue(uint64_t size, std::chrono::system_clock::time_point started) const;
+    // Renames path away and hands it to archiver, the file has to be closed already
+    void RotateFile(const std::string& path, LogArchiver& archiver);
+
+    // Async mode
+    LoggerOptions _options;
+    std::unique_ptr<LogRingBuffer<LogRecord>> _queue;
+    std::vector<LogRecord> _writerBatch;
+    std::thread _writerThread;
+    std::mutex _writerMutex;
+    std::condition_variable _writerWake;
+    std::condition_variable _writerDrained;
+    std::atomic<bool> _stopWriter{false};
+    bool _wakeRequested = false;
+    std::atomic<size_t> _writtenPosition{0};
+    std::atomic<uint64_t> _droppedCount{0};
+    void StartWriter();
+    void Enqueue(LogRecord&& record);
+    void WriterLoop();
+    bool DrainQueue();
+};
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "steam_backend.hpp"
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// A callback as the mock hands it out, id is the k_iCallback of the struct it stands for
+struct MockSteamCallback {
+    int id = 0;
+    std::vector<uint8_t> payload;
+};
+
+// In-process stand-in for steam_api. Deterministic: every call does exactly what the
+// script says after the scripted delay, and queued callbacks come out in order on
+// the RunCallbacks call they were scheduled for. No Steam client, no DLL, any platform.
+// After InitManualDispatch() the same queue comes out through RunManualFrame() and
+// GetNextCallback() instead, RunCallbacks() no longer delivers anything.
+class MockSteamBackend : public SteamBackend {
+public:
+    struct Script {
+        bool loadFails = false;
+        std::string loadError;
+        bool restartRequired = false;
+        SteamInitResult initResult = SteamInitResult::OK;
+        std::string initError;
+        // Interfaces that stay unavailable after a successful Init
+        std::bitset<static_cast<size_t>(SteamInterface::Count)> missingInterfaces;
+
+        // How long each call pretends to take
+        std::chrono::microseconds restartLatency{0};
+        std::chrono::microseconds initLatency{0};
+        std::chrono::microseconds probeLatency{0};
+        std::chrono::microseconds runCallbacksLatency{0};
+        std::chrono::microseconds shutdownLatency{0};
+    };
+
+    struct Counters {
+        uint64_t loadCalls = 0;
+        uint64_t restartCalls = 0;
+        uint64_t initCalls = 0;
+        uint64_t shutdownCalls = 0;
+        uint64_t runCallbacksCalls = 0;
+        uint64_t probeCalls = 0;
+        uint64_t callbacksDelivered = 0;
+        uint64_t manualFrames = 0;
+        uint64_t callResultsFetched = 0;
+    };
+
+    MockSteamBackend();
+    explicit MockSteamBackend(Script script);
+
+    // Delivered by the RunCallbacks call afterFrames calls from now (0 = the next one)
+    void QueueCallback(int id, std::vector<uint8_t> payload = {}, uint32_t afterFrames = 0);
+    // Finishes an API call: queues the SteamApiCallCompleted callback for it, and
+    // GetCallResult() hands out result once (manual dispatch only)
+    void QueueCallResult(uint64_t call, int resultId, std::vector<uint8_t> result, uint32_t afterFrames = 0, bool failed = false);
+    // Called for every delivered callback, on whatever thread runs RunCallbacks
+    void SetCallbackHandler(std::function<void(const MockSteamCallback&)> handler);
+    // Changes apply from the next call on
+    void SetScript(const Script& script);
+
+    Counters GetCounters() const;
+    bool IsInitialized() const;
+    size_t PendingCallbacks() const;
+    // Whatever the last Load() was asked to load
+    std::string GetLoadedPath() const;
+
+    bool Load(const std::string& libraryPath, std::string& error) override;
+    bool RestartAppIfNecessary(uint32_t appId) override;
+    SteamInitResult Init(std::string& error) override;
+    void Shutdown() override;
+    uint32_t RunCallbacks() override;
+    bool CountsCallbacks() const override;
+    bool HasInterface(SteamInterface which) override;
+    bool InitManualDispatch() override;
+    void RunManualFrame() override;
+    bool GetNextCallback(SteamCallbackMessage& message) override;
+    void FreeLastCallback() override;
+    bool GetCallResult(uint64_t call, void* result, uint32_t size, int resultId, bool& failed) override;
+
+private:
+    struct Pending {
+        uint64_t frame;
+        MockSteamCallback callback;
+    };
+
+    struct CallResult {
+        int id;
+        std::vector<uint8_t> result;
+        bool failed;
+    };
+
+    mutable std::mutex _mutex;
+    Script _script;
+    Counters _counters;
+    std::string _loadedPath;
+    bool _initialized = false;
+    uint64_t _frame = 0;
+    // Ordered by frame, callbacks for the same frame in the order they were queued
+    std::deque<Pending> _pending;
+    std::vector<MockSteamCallback> _due;
+    bool _manualDispatch = false;
+    // Manual dispatch: the next entry of _due GetNextCallback() hands out
+    size_t _nextDue = 0;
+    std::unordered_map<uint64_t, CallResult> _callResults;
+    std::function<void(const MockSteamCallback&)> _handler;
+
+    static void Delay(std::chrono::microseconds latency);
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+
+// A dll / shared object loaded at runtime (LoadLibraryW or dlopen). Unloaded when
+// this goes away, unless Release() was called first.
+class SharedLibrary {
+public:
+    SharedLibrary() = default;
+    ~SharedLibrary();
+
+    SharedLibrary(const SharedLibrary&) = delete;
+    SharedLibrary& operator=(const SharedLibrary&) = delete;
+
+    // path is UTF-8. On failure error names the file and says why, in the loader's own words
+    bool Open(const std::string& path, std::string& error);
+    void Close();
+    bool IsOpen() const;
+    const std::string& GetPath() const;
+
+    // Address of an exported symbol, nullptr if the library doesn't have it
+    void* FindSymbol(const char* name) const;
+
+    // Leaves the library loaded for the rest of the process, for libraries that start
+    // threads of their own and can't safely be unloaded
+    void Release();
+
+private:
+    void* _handle = nullptr;
+    std::string _path;
+};
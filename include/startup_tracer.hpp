@@ -0,0 +1,109 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Latencies in microseconds, bucketed log-linearly: exact below 8us, then 8 buckets
+// per power of two, so any value is off by at most 1/16 and the whole range up to
+// hours fits in a few hundred counters. Cheap to keep one per phase across runs.
+class LatencyHistogram {
+public:
+    static constexpr size_t kBucketCount = 320;
+
+    void Add(uint64_t micros, uint64_t count = 1);
+    uint64_t GetCount() const { return _count; }
+    // Value at or below which p (0..1) of the samples fall, 0 when empty
+    uint64_t Percentile(double p) const;
+
+    // "bucket:count" pairs for the non-empty buckets, space separated
+    std::string Serialize() const;
+    bool Deserialize(const std::string& text);
+
+    static size_t BucketOf(uint64_t micros);
+    static uint64_t LowerBound(size_t bucket);
+    static uint64_t Width(size_t bucket);
+
+private:
+    std::vector<uint64_t> _buckets = std::vector<uint64_t>(kBucketCount);
+    uint64_t _count = 0;
+};
+
+// Where launcher startup time goes. Phases are timed with TraceSpan on the monotonic
+// clock and kept in memory (a handful per run, so it's always on), and at exit they
+// can be written out as a Chrome trace (chrome://tracing or ui.perfetto.dev) and
+// folded into a stats file that keeps p50/p95/p99 per phase and launcher version.
+class StartupTracer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Span {
+        // A string literal, also used as the key in the stats file so no spaces in it
+        const char* name;
+        Clock::time_point start;
+        Clock::duration duration;
+        // Small per-tracer number, 1 is the thread that created the tracer
+        uint32_t thread;
+    };
+
+    // One phase over every run of one launcher version recorded in the stats file
+    struct PhaseStats {
+        std::string name;
+        uint64_t runs = 0;
+        uint64_t p50Us = 0;
+        uint64_t p95Us = 0;
+        uint64_t p99Us = 0;
+    };
+
+    StartupTracer();
+
+    void Record(const char* name, Clock::time_point start, Clock::time_point end);
+    std::vector<Span> GetSpans() const;
+    // When the tracer was created, which is where the trace starts
+    Clock::time_point GetOrigin() const { return _origin; }
+
+    // Runs function as one span and hands back whatever it returned
+    template <typename Function>
+    auto Time(const char* name, Function&& function) -> decltype(function());
+
+    bool WriteChromeTrace(const std::string& path) const;
+    // Adds this run's spans to the histograms in path (created if missing) under version
+    // and fills stats with that version's percentiles. Other versions are left as they were.
+    bool UpdateStats(const std::string& path, const std::string& version, std::vector<PhaseStats>& stats) const;
+    // This run's spans next to the aggregate, ready to print
+    std::string FormatSummary(const std::vector<PhaseStats>& stats) const;
+
+private:
+    mutable std::mutex _mutex;
+    Clock::time_point _origin;
+    std::vector<Span> _spans;
+    std::vector<std::thread::id> _threads;
+};
+
+// Times the enclosing scope as one span
+class TraceSpan {
+public:
+    TraceSpan(StartupTracer& tracer, const char* name)
+        : _tracer(tracer), _name(name), _start(StartupTracer::Clock::now()) {
+    }
+    ~TraceSpan() {
+        _tracer.Record(_name, _start, StartupTracer::Clock::now());
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    StartupTracer& _tracer;
+    const char* _name;
+    StartupTracer::Clock::time_point _start;
+};
+
+template <typename Function>
+auto StartupTracer::Time(const char* name, Function&& function) -> decltype(function()) {
+    TraceSpan span(*this, name);
+    return function();
+}
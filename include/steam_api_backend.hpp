@@ -0,0 +1,38 @@
+#pragma once
+
+#include "steam_backend.hpp"
+#include "shared_library.hpp"
+#include <memory>
+
+// The real steam_api(64).dll (libsteam_api.so elsewhere), loaded at runtime by Load()
+// rather than linked, so nothing touches it until the launcher actually wants Steam.
+// Every export it uses is resolved once, up front, into a typed table. The manual
+// dispatch exports are the only optional ones, InitManualDispatch() says if they're there.
+class SteamApiBackend : public SteamBackend {
+public:
+    SteamApiBackend();
+    ~SteamApiBackend() override;
+
+    bool Load(const std::string& libraryPath, std::string& error) override;
+    bool RestartAppIfNecessary(uint32_t appId) override;
+    SteamInitResult Init(std::string& error) override;
+    void Shutdown() override;
+    uint32_t RunCallbacks() override;
+    bool CountsCallbacks() const override;
+    bool HasInterface(SteamInterface which) override;
+    bool InitManualDispatch() override;
+    void RunManualFrame() override;
+    bool GetNextCallback(SteamCallbackMessage& message) override;
+    void FreeLastCallback() override;
+    bool GetCallResult(uint64_t call, void* result, uint32_t size, int resultId, bool& failed) override;
+
+private:
+    struct Functions;
+
+    SharedLibrary _library;
+    // Null until Load() succeeded, then every entry in it is valid except the manual dispatch ones
+    std::unique_ptr<Functions> _functions;
+    bool _initialized = false;
+    // HSteamPipe, set by InitManualDispatch()
+    int32_t _pipe = 0;
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Same values as ESteamAPIInitResult, without pulling the Steam headers in
+enum class SteamInitResult : int {
+    OK = 0,
+    FailedGeneric = 1,
+    NoSteamClient = 2,
+    VersionMismatch = 3
+};
+
+// The Steam interfaces the launcher looks for after init
+enum class SteamInterface : uint8_t {
+    User,
+    Apps,
+    GameServer,
+    UGC,
+    HTTP,
+    Networking,
+    Client,
+    Count
+};
+
+const char* SteamInterfaceName(SteamInterface which);
+
+// A callback as manual dispatch hands it out. data stays valid until FreeLastCallback()
+struct SteamCallbackMessage {
+    int id = 0;
+    const uint8_t* data = nullptr;
+    uint32_t size = 0;
+};
+
+// SteamAPICallCompleted_t: the payload of the callback that says a call result is ready.
+// Same layout as the SDK's on every platform (checked in steam_api_backend.cpp)
+struct SteamApiCallCompleted {
+    static constexpr int kCallbackId = 703;
+    uint64_t call;
+    int32_t resultId;
+    uint32_t resultSize;
+};
+
+// Exactly the part of steam_api the launcher uses. SteamApiBackend is the real one,
+// MockSteamBackend a scriptable fake, so everything above this builds and runs
+// without a Steam client (or Windows).
+class SteamBackend {
+public:
+    virtual ~SteamBackend() = default;
+
+    // Gets the backend ready to use, for the real one that means loading the library at
+    // libraryPath. Called before anything else; false (and error) means no Steam at all
+    virtual bool Load(const std::string& libraryPath, std::string& error) = 0;
+    virtual bool RestartAppIfNecessary(uint32_t appId) = 0;
+    // error gets Steam's explanation when the result isn't OK
+    virtual SteamInitResult Init(std::string& error) = 0;
+    virtual void Shutdown() = 0;
+    // Callbacks delivered by this call, 0 if there were none or the backend can't tell
+    virtual uint32_t RunCallbacks() = 0;
+    // Whether RunCallbacks() actually counts. If not, its 0 says nothing about being idle
+    virtual bool CountsCallbacks() const = 0;
+    // Whether Steam hands out the interface, only meaningful after a successful Init
+    virtual bool HasInterface(SteamInterface which) = 0;
+
+    // Manual dispatch, the alternative to RunCallbacks (see SteamCallbackDispatcher).
+    // Switched on once after a successful Init, false if the backend can't do it
+    virtual bool InitManualDispatch() = 0;
+    virtual void RunManualFrame() = 0;
+    // False once the frame has nothing left. FreeLastCallback() has to come before the next call
+    virtual bool GetNextCallback(SteamCallbackMessage& message) = 0;
+    virtual void FreeLastCallback() = 0;
+    // Copies the result of a finished call into result. failed is Steam's IO failure flag
+    virtual bool GetCallResult(uint64_t call, void* result, uint32_t size, int resultId, bool& failed) = 0;
+};
@@ -0,0 +1,317 @@
+#pragma once
+
+#include "steam_backend.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+// One entry of a callback table: which callback, how big its struct is and who gets it
+template <typename Context>
+struct SteamCallbackRoute {
+    int id = 0;
+    uint32_t size = 0;
+    void (*handler)(Context& context, const void* data) = nullptr;
+};
+
+// Route for Callback (an SDK callback struct, anything with a k_iCallback) to Handler.
+// The cast from the raw payload lives here, handlers only ever see the typed struct.
+template <typename Context, typename Callback, void (*Handler)(Context&, const Callback&)>
+constexpr SteamCallbackRoute<Context> MakeCallbackRoute() {
+    return SteamCallbackRoute<Context>{ static_cast<int>(Callback::k_iCallback), static_cast<uint32_t>(sizeof(Callback)),
+        [](Context& context, const void* data) { Handler(context, *static_cast<const Callback*>(data)); } };
+}
+
+// Callback id -> route. Same idea as the config schema's key table: the seed is searched
+// for at compile time so every id gets a slot of its own, a lookup is one multiply,
+// one shift and one compare. Build it constexpr and static_assert IsValid().
+template <typename Context, size_t N>
+class SteamCallbackTable {
+public:
+    static_assert(N > 0 && N < 255, "a callback table needs between 1 and 254 routes");
+
+    // About 4x the route count, as a power of two so the slot is just the hash's top bits
+    static constexpr unsigned kBits = [] {
+        unsigned bits = 3;
+        while ((size_t(1) << bits) < N * 4) bits++;
+        return bits;
+    }();
+    static constexpr size_t kSize = size_t(1) << kBits;
+
+    constexpr explicit SteamCallbackTable(const std::array<SteamCallbackRoute<Context>, N>& routes)
+        : _routes(routes), _slots{}, _seed(FindSeed(routes)) {
+        for (size_t i = 0; i < kSize; i++) _slots[i] = kEmptySlot;
+        if (_seed != 0) {
+            for (size_t i = 0; i < N; i++) {
+                _slots[Slot(routes[i].id, _seed)] = static_cast<uint8_t>(i);
+            }
+        }
+    }
+
+    // False for duplicate ids or no usable seed
+    constexpr bool IsValid() const { return _seed != 0; }
+
+    // Null if nothing handles id
+    constexpr const SteamCallbackRoute<Context>* Find(int id) const {
+        uint8_t index = _slots[Slot(id, _seed)];
+        if (index == kEmptySlot || _routes[index].id != id) return nullptr;
+        return &_routes[index];
+    }
+
+private:
+    static constexpr uint8_t kEmptySlot = 0xFF;
+
+    std::array<SteamCallbackRoute<Context>, N> _routes;
+    std::array<uint8_t, kSize> _slots;
+    uint32_t _seed;
+
+    static constexpr size_t Slot(int id, uint32_t seed) {
+        return static_cast<size_t>(((static_cast<uint32_t>(id) ^ seed) * 0x9E3779B9u) >> (32 - kBits));
+    }
+
+    static constexpr uint32_t FindSeed(const std::array<SteamCallbackRoute<Context>, N>& routes) {
+        for (uint32_t seed = 1; seed < 10000; seed++) {
+            bool used[kSize] = {};
+            bool collision = false;
+            for (const SteamCallbackRoute<Context>& route : routes) {
+                size_t slot = Slot(route.id, seed);
+                if (used[slot]) {
+                    collision = true;
+                    break;
+                }
+                used[slot] = true;
+            }
+            if (!collision) return seed;
+        }
+        return 0;
+    }
+};
+
+// SteamAPICall_t -> whoever waits for its result. Open addressing with linear probing in
+// one flat array that is sized up front, so neither Insert nor Take allocates. Take shifts
+// the entries behind it back instead of leaving tombstones. Not thread safe by itself.
+template <typename Context>
+class SteamCallResultMap {
+public:
+    using Handler = void (*)(Context& context, const void* result, bool failed);
+
+    struct Entry {
+        uint64_t call = 0; // 0 is k_uAPICallInvalid, marks a free slot
+        int resultId = 0;
+        uint32_t resultSize = 0;
+        Handler handler = nullptr;
+    };
+
+    // Room for capacity calls, the table is kept at most half full
+    explicit SteamCallResultMap(size_t capacity) : _capacity(capacity > 0 ? capacity : 1) {
+        size_t size = 8;
+        while (size < _capacity * 2) size *= 2;
+        _entries.reset(new Entry[size]);
+        _mask = size - 1;
+    }
+
+    // False when full, for call 0, or when someone already waits on call
+    bool Insert(const Entry& entry) {
+        if (entry.call == 0 || _size >= _capacity) {
+            return false;
+        }
+        size_t index = Home(entry.call);
+        while (_entries[index].call != 0) {
+            if (_entries[index].call == entry.call) return false;
+            index = (index + 1) & _mask;
+        }
+        _entries[index] = entry;
+        _size++;
+        return true;
+    }
+
+    // Removes call, false if nobody waited on it
+    bool Take(uint64_t call, Entry& entry) {
+        if (call == 0) {
+            return false;
+        }
+        size_t index = Home(call);
+        while (_entries[index].call != call) {
+            if (_entries[index].call == 0) return false;
+            index = (index + 1) & _mask;
+        }
+        entry = _entries[index];
+        _size--;
+
+        // Pull back everything in the run that may sit in the hole, so a lookup can
+        // still stop at the first free slot
+        size_t hole = index;
+        for (size_t next = (hole + 1) & _mask; _entries[next].call != 0; next = (next + 1) & _mask) {
+            size_t home = Home(_entries[next].call);
+            if (((next - home) & _mask) >= ((next - hole) & _mask)) {
+                _entries[hole] = _entries[next];
+                hole = next;
+            }
+        }
+        _entries[hole] = Entry();
+        return true;
+    }
+
+    size_t Size() const { return _size; }
+    size_t Capacity() const { return _capacity; }
+
+private:
+    std::unique_ptr<Entry[]> _entries;
+    size_t _mask = 0;
+    size_t _size = 0;
+    size_t _capacity;
+
+    size_t Home(uint64_t call) const {
+        // Call handles mostly differ in their low bits, the multiply spreads them over the top ones
+        return static_cast<size_t>((call * 0x9E3779B97F4A7C15ull) >> 40) & _mask;
+    }
+};
+
+// The manual-dispatch replacement for SteamAPI_RunCallbacks. Callbacks reach their handler
+// through a SteamCallbackTable, finished API calls reach whoever AwaitCallResult()'ed them
+// through a SteamCallResultMap, and results are fetched into one buffer allocated up
+// front. Nothing in RunFrame() allocates. RunFrame() belongs on the callback thread (the
+// pump's frame), AwaitCallResult() and GetStats() can come from any thread.
+template <typename Context, size_t N>
+class SteamCallbackDispatcher {
+public:
+    using CallResultHandler = typename SteamCallResultMap<Context>::Handler;
+
+    struct Stats {
+        uint64_t frames = 0;
+        // Reached a handler from the table
+        uint64_t callbacks = 0;
+        // Reached the handler waiting on them, failed ones included
+        uint64_t callResults = 0;
+        // No handler in the table, or nobody waiting on the call
+        uint64_t unhandled = 0;
+        // Size or id didn't match what the handler was built for, never handed to it
+        uint64_t dropped = 0;
+    };
+
+    SteamCallbackDispatcher(SteamBackend& steam, Context& context, const SteamCallbackTable<Context, N>& table,
+                            size_t maxPendingCalls = 64, size_t maxResultSize = 16 * 1024)
+        : _steam(steam), _context(context), _table(table), _calls(maxPendingCalls),
+          _result(new std::max_align_t[(maxResultSize + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t)]),
+          _resultCapacity(maxResultSize) {
+    }
+
+    SteamCallbackDispatcher(const SteamCallbackDispatcher&) = delete;
+    SteamCallbackDispatcher& operator=(const SteamCallbackDispatcher&) = delete;
+
+    // Handler gets the Result (an SDK call result struct) of call exactly once. failed is
+    // set on an IO failure, or when the result didn't come back as a Result; then the
+    // struct is whatever Steam (or nobody) left in the buffer, like with CCallResult.
+    // False if call is already waited on or too many are.
+    template <typename Result, void (*Handler)(Context&, const Result&, bool failed)>
+    bool AwaitCallResult(uint64_t call) {
+        return AwaitCallResult(call, static_cast<int>(Result::k_iCallback), static_cast<uint32_t>(sizeof(Result)),
+            [](Context& context, const void* result, bool failed) { Handler(context, *static_cast<const Result*>(result), failed); });
+    }
+
+    bool AwaitCallResult(uint64_t call, int resultId, uint32_t resultSize, CallResultHandler handler) {
+        if (!handler || resultSize > _resultCapacity) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _calls.Insert({ call, resultId, resultSize, handler });
+    }
+
+    // Gives up on call, its result counts as unhandled when it shows up
+    bool CancelCallResult(uint64_t call) {
+        typename SteamCallResultMap<Context>::Entry entry;
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _calls.Take(call, entry);
+    }
+
+    // One frame: lets Steam do its work, then hands out everything it has.
+    // Returns how many callbacks and call results reached a handler
+    uint32_t RunFrame() {
+        Stats frame;
+        frame.frames = 1;
+        _steam.RunManualFrame();
+
+        SteamCallbackMessage message;
+        while (_steam.GetNextCallback(message)) {
+            // Has to be freed before the next GetNextCallback, even when a handler throws
+            struct FreeLast {
+                SteamBackend& steam;
+                ~FreeLast() { steam.FreeLastCallback(); }
+            } freeLast{ _steam };
+
+            if (message.id == SteamApiCallCompleted::kCallbackId) {
+                DispatchCallResult(message, frame);
+            } else if (const SteamCallbackRoute<Context>* route = _table.Find(message.id)) {
+                if (message.size == route->size) {
+                    frame.callbacks++;
+                    route->handler(_context, message.data);
+                } else {
+                    frame.dropped++;
+                }
+            } else {
+                frame.unhandled++;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stats.frames += frame.frames;
+        _stats.callbacks += frame.callbacks;
+        _stats.callResults += frame.callResults;
+        _stats.unhandled += frame.unhandled;
+        _stats.dropped += frame.dropped;
+        return static_cast<uint32_t>(frame.callbacks + frame.callResults);
+    }
+
+    Stats GetStats() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _stats;
+    }
+
+    size_t PendingCallResults() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _calls.Size();
+    }
+
+private:
+    SteamBackend& _steam;
+    Context& _context;
+    const SteamCallbackTable<Context, N>& _table;
+
+    mutable std::mutex _mutex;
+    SteamCallResultMap<Context> _calls;
+    Stats _stats;
+    std::unique_ptr<std::max_align_t[]> _result;
+    size_t _resultCapacity;
+
+    void DispatchCallResult(const SteamCallbackMessage& message, Stats& frame) {
+        SteamApiCallCompleted completed;
+        if (message.size != sizeof(completed)) {
+            frame.dropped++;
+            return;
+        }
+        std::memcpy(&completed, message.data, sizeof(completed));
+
+        typename SteamCallResultMap<Context>::Entry waiting;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!_calls.Take(completed.call, waiting)) {
+                frame.unhandled++;
+                return;
+            }
+        }
+
+        // Whatever goes wrong, the waiter still hears back exactly once
+        bool failed = true;
+        if (completed.resultId == waiting.resultId && completed.resultSize == waiting.resultSize) {
+            if (!_steam.GetCallResult(completed.call, _result.get(), waiting.resultSize, waiting.resultId, failed)) {
+                failed = true;
+            }
+        } else {
+            frame.dropped++;
+        }
+        frame.callResults++;
+        waiting.handler(_context, _result.get(), failed);
+    }
+};
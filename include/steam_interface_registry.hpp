@@ -0,0 +1,93 @@
+#pragma once
+
+#include "steam_backend.hpp"
+#include "startup_tracer.hpp"
+#include <atomic>
+#include <bitset>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// When an interface gets probed
+enum class InterfaceUse : uint8_t {
+    Required, // on the critical path, before the game starts
+    Optional, // on a background thread once the game has been started
+    Lazy      // only the first time somebody asks for it
+};
+
+struct SteamInterfaceSpec {
+    SteamInterface which;
+    InterfaceUse use;
+};
+
+// The launcher only needs a user to hand Steam to the game, everything else is only
+// looked at for the log. Nothing starts a game server, so that one waits to be asked.
+inline constexpr SteamInterfaceSpec kSteamInterfaceSpecs[] = {
+    {SteamInterface::User, InterfaceUse::Required},
+    {SteamInterface::Apps, InterfaceUse::Optional},
+    {SteamInterface::GameServer, InterfaceUse::Lazy},
+    {SteamInterface::UGC, InterfaceUse::Optional},
+    {SteamInterface::HTTP, InterfaceUse::Optional},
+    {SteamInterface::Networking, InterfaceUse::Optional},
+    {SteamInterface::Client, InterfaceUse::Optional},
+};
+
+constexpr bool IsValidInterfaceSpecs() {
+    size_t i = 0;
+    for (const SteamInterfaceSpec& spec : kSteamInterfaceSpecs) {
+        if (static_cast<size_t>(spec.which) != i++) return false;
+    }
+    return i == static_cast<size_t>(SteamInterface::Count);
+}
+static_assert(IsValidInterfaceSpecs(), "kSteamInterfaceSpecs needs one entry per SteamInterface, in enum order");
+
+// Probes the interfaces in kSteamInterfaceSpecs at the time their InterfaceUse says
+// and remembers the answers. Which ones have been probed and which were there are
+// two bitsets, so asking is a load, from any thread, without a lock.
+class SteamInterfaceRegistry {
+public:
+    using Mask = std::bitset<static_cast<size_t>(SteamInterface::Count)>;
+    // Called once per probe with the answer, on whatever thread probed it
+    using ResultHandler = std::function<void(SteamInterface which, InterfaceUse use, bool available)>;
+
+    // tracer (optional) gets one span per probe
+    explicit SteamInterfaceRegistry(std::shared_ptr<SteamBackend> steam, StartupTracer* tracer = nullptr);
+    ~SteamInterfaceRegistry();
+
+    SteamInterfaceRegistry(const SteamInterfaceRegistry&) = delete;
+    SteamInterfaceRegistry& operator=(const SteamInterfaceRegistry&) = delete;
+
+    void SetResultHandler(ResultHandler handler);
+
+    // Probes every required interface on this thread, false if any of them is missing
+    bool ProbeRequired();
+    // Probes the optional ones on a background thread and returns straight away.
+    // Does nothing if they're already being (or have been) probed
+    void ProbeOptionalAsync();
+    // Blocks until the background probes are done. Has to happen before Steam shuts down
+    void Wait();
+    // Forgets every answer, for after a Steam shutdown. Waits for the background probes first
+    void Reset();
+
+    // Whether Steam hands out which. An interface nobody probed yet (a lazy one, or an
+    // optional one the background thread hasn't got to) is probed right here
+    bool IsAvailable(SteamInterface which);
+    Mask GetProbed() const;
+    Mask GetAvailable() const;
+
+private:
+    std::shared_ptr<SteamBackend> _steam;
+    StartupTracer* _tracer;
+    std::mutex _handlerMutex;
+    ResultHandler _handler;
+    // One bit per SteamInterface
+    std::atomic<uint32_t> _probed{0};
+    std::atomic<uint32_t> _available{0};
+    std::mutex _threadMutex;
+    std::thread _thread;
+    bool _optionalStarted = false;
+
+    bool Probe(SteamInterface which);
+};
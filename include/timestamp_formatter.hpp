@@ -0,0 +1,46 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+enum class TimestampPrecision {
+    Seconds,      // 2024-01-31 13:37:00
+    Milliseconds, // 2024-01-31 13:37:00.123
+    Microseconds  // 2024-01-31 13:37:00.123456
+};
+
+enum class TimestampClock {
+    System,   // wall clock, follows system time changes
+    Monotonic // wall clock at startup plus steady_clock elapsed, never jumps backwards
+};
+
+// Formats "YYYY-mm-dd HH:MM:SS" timestamps without allocating.
+// The formatted second is cached and only the seconds digits are rewritten while
+// we stay inside the same minute, so localtime only runs about once a minute.
+// Not thread-safe, the logger only calls Format() while holding its lock.
+class TimestampFormatter {
+public:
+    static constexpr size_t kMaxLength = 26;
+
+    explicit TimestampFormatter(TimestampPrecision precision = TimestampPrecision::Seconds,
+                                TimestampClock clock = TimestampClock::System);
+
+    // Current time according to the configured clock, safe to call from any thread
+    std::chrono::system_clock::time_point Now() const;
+
+    // Writes the timestamp into buffer (at least kMaxLength bytes) and returns its length
+    size_t Format(char* buffer, std::chrono::system_clock::time_point time);
+    size_t Format(char* buffer);
+
+private:
+    TimestampPrecision _precision;
+    TimestampClock _clock;
+    std::chrono::system_clock::time_point _systemOrigin;
+    std::chrono::steady_clock::time_point _steadyOrigin;
+
+    char _cached[19];
+    int64_t _cachedSecond;
+    int64_t _cachedMinuteStart;
+    void FormatSecond(int64_t second);
+};
@@ -1,37 +1,75 @@
 #pragma once
 
 #include "ini_config.hpp"
+#include "config_watcher.hpp"
+#include "layered_config.hpp"
 #include "logger.hpp"
 #include "path_utils.hpp"
+#include "launcher_traits.hpp"
+#include "steam_backend.hpp"
+#include "startup_tracer.hpp"
+#include "steam_interface_registry.hpp"
+#include "callback_pump.hpp"
+#include "exit_events.hpp"
+#include <bitset>
 #include <string>
 #include <memory>
-#include <windows.h>
-#include <steam/steam_api.h>
-#include <steam/isteamgameserver.h>
-#include <steam/isteamugc.h>
-#include <steam/isteamhttp.h>
-#include <steam/isteamnetworking.h>
-
-class UCOnline {
+#include <atomic>
+
+// The launcher itself, shared by both builds. Traits (see launcher_traits.hpp) supplies
+// the names that differ between them. Both versions are instantiated in uc_online.cpp.
+template <typename Traits>
+class UCOnlineLauncher {
 public:
-    UCOnline(const std::string& iniFilePath = "config.ini");
-    ~UCOnline();
+    // steam is what actually talks to Steam (SteamApiBackend, or MockSteamBackend without a client).
+    // commandLine is the top config layer, see LayeredConfig for the others
+    explicit UCOnlineLauncher(std::shared_ptr<SteamBackend> steam, const std::string& iniFilePath = "config.ini",
+                              const ConfigOverrides& commandLine = ConfigOverrides());
+    ~UCOnlineLauncher();
 
     bool InitializeUCOnline();
     void ShutdownUCOnline();
-    void RunSteamCallbacks();
+    // Runs the callbacks on their own thread at CallbackRateHz until StopCallbackPump() or shutdown.
+    // False if Steam isn't initialized
+    bool StartCallbackPump();
+    void StopCallbackPump();
+    // Something is on its way, run the next frame now
+    void WakeCallbackPump();
+    CallbackPump::Stats GetCallbackPumpStats() const;
+    // Blocks until the game exits, Ctrl+C / SIGTERM, RequestExit() or timeout (zero = no limit).
+    // Whatever ended it first is the answer from then on. Edits to config.ini are applied
+    // (ApplyConfigChanges) on this thread while it waits
+    ExitReason WaitForExit(std::chrono::milliseconds timeout);
+    void RequestExit();
     void SetCustomAppID(uint32_t appID);
     uint32_t GetCurrentAppID() const;
     bool IsSteamInitialized() const;
+    // Whether Steam hands out which, probed on the spot if nothing has asked before
+    bool HasSteamInterface(SteamInterface which);
+    // Interfaces known to be there so far, never blocks
+    std::bitset<static_cast<size_t>(SteamInterface::Count)> GetAvailableSteamInterfaces() const;
 
     void CreateAppIdFile();
+    // Needs InitializeUCOnline() first
     bool LaunchGame();
+    // Both in one go (PipelinedLaunch): the game is created suspended while Steam starts on
+    // another thread, then resumed as soon as SteamAPI_InitEx succeeded, or killed if it didn't
+    bool LaunchGamePipelined();
     void SetGameExecutable(const std::string& gameExePath);
     void SetGameArguments(const std::string& arguments);
     std::string GetGameExecutable() const;
     std::string GetGameArguments() const;
     void SaveConfig();
     void ReloadConfig();
+    // Switches to the watcher's latest snapshot of config.ini if there is a newer one, true if there was.
+    // The watcher already parsed it, nothing is read from disk here
+    bool ApplyConfigChanges();
+    // Any Set* calls made while the returned transaction is alive are written to config.ini once, when it ends
+    ConfigTransaction BeginConfigTransaction();
+    // Defaults, machine ini, config.ini, environment and command line merged together
+    const LayeredConfig& GetResolvedConfig() const;
+    // Every startup phase so far, written out at exit when [Tracing] TraceStartup is on
+    const StartupTracer& GetStartupTracer() const;
 
     Logger* GetLogger();
     void SetLoggingEnabled(bool enabled);
@@ -42,18 +80,78 @@ public:
     void SetSteamApiDllPath(const std::string& dllPath);
 
 private:
+    // First member, so the trace starts before anything else is set up
+    StartupTracer _tracer;
+    std::shared_ptr<SteamBackend> _steam;
+    // See kSteamInterfaceSpecs for what gets probed when
+    SteamInterfaceRegistry _interfaces;
     bool _steamInitialized = false;
     uint32_t _currentAppID;
     std::unique_ptr<IniConfig> _config;
+    // The other layers never change after startup, so the watcher thread can read them too
+    std::unique_ptr<IniConfig> _machineConfig;
+    ConfigOverrides _environment;
+    ConfigOverrides _commandLine;
+    std::shared_ptr<const LayeredConfig> _resolved;
     std::unique_ptr<Logger> _logger;
+    // Declared after the logger so its thread is stopped before the logger goes away
+    std::unique_ptr<ConfigWatcher> _configWatcher;
+    // Snapshot version of _configWatcher that _resolved was built from
+    uint64_t _appliedConfigVersion = 0;
     std::string _gameExecutable;
     std::string _gameArguments;
     std::string _steamApiDllPath;
 
+    // The game once started. Handles are kept so it can be resumed, or waited on
+    struct GameProcess {
+        uint32_t id = 0;
+#ifdef _WIN32
+        void* process = nullptr;
+        // Only while suspended
+        void* thread = nullptr;
+#else
+        // Write end of the pipe a suspended child waits on before exec
+        int gate = -1;
+#endif
+    };
+    GameProcess _game;
+    // Handler table for ManualCallbackDispatch, lives in uc_online.cpp. Null while Steam dispatches them itself
+    struct CallbackDispatch;
+    std::unique_ptr<CallbackDispatch> _callbackDispatch;
+    // After the dispatcher, so it's stopped before the dispatcher goes away
+    std::unique_ptr<CallbackPump> _callbackPump;
+    ExitEvents _exitEvents;
+
+    void StartConfigWatcher();
+    void ResolveConfig();
+    // Takes appid, executable and arguments from _resolved
+    void ApplyResolvedConfig();
+    // Where Load() looks for steam_api, SteamApiDLLPath plus the library name
+    std::string GetSteamApiLibraryPath() const;
+    // Trace file, stats file and the summary table, if tracing is on
+    void FinishStartupTrace();
+    // Load, restart check and SteamAPI_InitEx, everything up to the interfaces
+    bool StartSteam();
+    // Switches to manual dispatch if ManualCallbackDispatch is on and steam_api can do it
+    void StartCallbackDispatch();
+    // One frame, through whichever of the two dispatches callbacks
+    uint32_t RunCallbackFrame();
+    // The required interfaces, false if one is missing
     bool InitializeSteamInterfaces();
-    bool InitializeSteamGameServer();
-    bool InitializeSteamUGC();
-    bool InitializeSteamHTTP();
-    bool InitializeSteamNetworking();
-    bool InitializeSteamClient();
-};
\ No newline at end of file
+    void LogInterfaceProbe(SteamInterface which, InterfaceUse use, bool available);
+    bool CheckGameExecutable();
+    void OnGameStarted();
+    // SteamAppId / SteamGameId for a game created before Steam is up
+    void ExportSteamEnvironment();
+    // CreateProcessW on Windows, fork and exec everywhere else. Suspended: created but not running yet
+    bool StartGameProcess(bool suspended);
+    bool ResumeGameProcess();
+    void TerminateGameProcess();
+    void CloseGameProcess();
+};
+
+extern template class UCOnlineLauncher<Launcher32Traits>;
+extern template class UCOnlineLauncher<Launcher64Traits>;
+
+using UCOnline = UCOnlineLauncher<Launcher32Traits>;
+using UCOnline64 = UCOnlineLauncher<Launcher64Traits>;
@@ -0,0 +1,176 @@
+#include "atomic_file.hpp"
+#include "path_utils.hpp"
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <algorithm>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+AtomicFileWriter::AtomicFileWriter(bool flushToDisk) : _flushToDisk(flushToDisk) {
+}
+
+#ifdef _WIN32
+
+bool AtomicFileWriter::Write(const std::string& path, std::string_view contents) {
+    std::string tempPath = path + ".tmp";
+    std::wstring wideTempPath = PathUtils::ToPath(tempPath).wstring();
+    HANDLE file = CreateFileW(wideTempPath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "Error creating temp file: " << tempPath << " (" << GetLastError() << ")" << std::endl;
+        return false;
+    }
+
+    bool ok = true;
+    size_t written = 0;
+    while (ok && written < contents.size()) {
+        DWORD chunk = static_cast<DWORD>(std::min<size_t>(contents.size() - written, 1u << 30));
+        DWORD done = 0;
+        ok = WriteFile(file, contents.data() + written, chunk, &done, nullptr) != 0;
+        written += done;
+    }
+    // Make sure the data is on disk before the rename can make it visible
+    ok = ok && (!_flushToDisk || FlushFileBuffers(file) != 0);
+    CloseHandle(file);
+
+    if (!ok) {
+        std::cerr << "Error writing temp file: " << tempPath << " (" << GetLastError() << ")" << std::endl;
+        DeleteFileW(wideTempPath.c_str());
+        return false;
+    }
+    DWORD moveFlags = MOVEFILE_REPLACE_EXISTING | (_flushToDisk ? MOVEFILE_WRITE_THROUGH : 0);
+    if (!MoveFileExW(wideTempPath.c_str(), PathUtils::ToPath(path).c_str(), moveFlags)) {
+        std::cerr << "Error replacing " << path << " (" << GetLastError() << ")" << std::endl;
+        DeleteFileW(wideTempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+FileLock::FileLock(const std::string& path) {
+    std::string lockPath = path + ".lock";
+    HANDLE handle = CreateFileW(PathUtils::ToPath(lockPath).c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        std::cerr << "Could not open lock file: " << lockPath << std::endl;
+        return;
+    }
+    _handle = handle;
+
+    OVERLAPPED overlapped = {};
+    _locked = LockFileEx(handle, LOCKFILE_EXCLUSIVE_LOCK, 0, 1, 0, &overlapped) != 0;
+    if (!_locked) {
+        std::cerr << "Could not lock: " << lockPath << " (" << GetLastError() << ")" << std::endl;
+    }
+}
+
+FileLock::~FileLock() {
+    if (!_handle) return;
+    if (_locked) {
+        OVERLAPPED overlapped = {};
+        UnlockFileEx(_handle, 0, 1, 0, &overlapped);
+    }
+    // The lock file itself stays, deleting it would let two instances lock different files
+    CloseHandle(_handle);
+}
+
+#else
+
+bool AtomicFileWriter::Write(const std::string& path, std::string_view contents) {
+    std::string tempPath = path + ".tmp";
+
+    // Keep the permissions of the file being replaced
+    mode_t mode = 0644;
+    struct stat existing;
+    if (stat(path.c_str(), &existing) == 0) {
+        mode = existing.st_mode & 07777;
+    }
+
+    int fd = open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, mode);
+    if (fd < 0) {
+        std::cerr << "Error creating temp file: " << tempPath << " (" << std::strerror(errno) << ")" << std::endl;
+        return false;
+    }
+
+    bool ok = true;
+    size_t written = 0;
+    while (ok && written < contents.size()) {
+        ssize_t done = ::write(fd, contents.data() + written, contents.size() - written);
+        if (done < 0) {
+            ok = errno == EINTR;
+            continue;
+        }
+        written += static_cast<size_t>(done);
+    }
+    // Make sure the data is on disk before the rename can make it visible
+    ok = ok && (!_flushToDisk || fsync(fd) == 0);
+    if (close(fd) != 0) ok = false;
+
+    if (!ok) {
+        std::cerr << "Error writing temp file: " << tempPath << " (" << std::strerror(errno) << ")" << std::endl;
+        unlink(tempPath.c_str());
+        return false;
+    }
+    if (rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::cerr << "Error replacing " << path << " (" << std::strerror(errno) << ")" << std::endl;
+        unlink(tempPath.c_str());
+        return false;
+    }
+
+    if (!_flushToDisk) return true;
+
+    // The rename only survives a power cut once the directory entry is flushed too
+    size_t slash = path.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    int dirFd = open(directory.c_str(), O_RDONLY | O_CLOEXEC);
+    if (dirFd >= 0) {
+        fsync(dirFd);
+        close(dirFd);
+    }
+    return true;
+}
+
+FileLock::FileLock(const std::string& path) {
+    std::string lockPath = path + ".lock";
+    _fd = open(lockPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (_fd < 0) {
+        std::cerr << "Could not open lock file: " << lockPath << " (" << std::strerror(errno) << ")" << std::endl;
+        return;
+    }
+
+    int result;
+    do {
+        result = flock(_fd, LOCK_EX);
+    } while (result != 0 && errno == EINTR);
+    _locked = result == 0;
+    if (!_locked) {
+        std::cerr << "Could not lock: " << lockPath << " (" << std::strerror(errno) << ")" << std::endl;
+    }
+}
+
+FileLock::~FileLock() {
+    if (_fd < 0) return;
+    if (_locked) {
+        flock(_fd, LOCK_UN);
+    }
+    // The lock file itself stays, deleting it would let two instances lock different files
+    close(_fd);
+}
+
+#endif
+
+bool FileLock::IsLocked() const {
+    return _locked;
+}
+
+std::shared_ptr<FileWriter> AtomicFileWriter::Default() {
+    static std::shared_ptr<FileWriter> writer = std::make_shared<AtomicFileWriter>();
+    return writer;
+}
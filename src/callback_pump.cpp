@@ -0,0 +1,104 @@
+#include "callback_pump.hpp"
+#include <algorithm>
+#include <exception>
+#include <iostream>
+
+CallbackPump::CallbackPump(Frame frame, const CallbackPumpOptions& options)
+    : _frame(std::move(frame)),
+      _busyInterval(1000 / std::max<uint32_t>(1, std::min<uint32_t>(options.frequencyHz, 1000))),
+      _maxIdleInterval(std::max<uint32_t>(options.maxIdleIntervalMs, 1)) {
+    _maxIdleInterval = std::max(_maxIdleInterval, _busyInterval);
+}
+
+CallbackPump::~CallbackPump() {
+    Stop();
+}
+
+void CallbackPump::Start() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_thread.joinable()) {
+        return;
+    }
+    _stopRequested = false;
+    _wakeRequested = false;
+    _windowStart = Clock::now();
+    _thread = std::thread([this]() { Run(); });
+}
+
+void CallbackPump::Stop() {
+    std::thread thread;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopRequested = true;
+        thread = std::move(_thread);
+    }
+    _wakeup.notify_all();
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void CallbackPump::Wake() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _wakeRequested = true;
+    }
+    _wakeup.notify_all();
+}
+
+bool CallbackPump::IsRunning() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _thread.joinable() && !_stopRequested;
+}
+
+CallbackPump::Stats CallbackPump::GetStats() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+void CallbackPump::Run() {
+    std::chrono::milliseconds interval = _busyInterval;
+    for (;;) {
+        Clock::time_point frameStart = Clock::now();
+        uint32_t delivered = 0;
+        try {
+            delivered = _frame();
+        } catch (const std::exception& ex) {
+            std::cerr << "Exception while running Steam callbacks: " << ex.what() << std::endl;
+        }
+        Clock::time_point frameEnd = Clock::now();
+
+        // Back off while nothing is happening, straight back to full speed once something does
+        interval = delivered > 0 ? _busyInterval : std::min(interval * 2, _maxIdleInterval);
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _stats.frames++;
+        _stats.callbacks += delivered;
+        _stats.dispatchTime += frameEnd - frameStart;
+        _windowFrames++;
+        _windowCallbacks += delivered;
+        _windowDispatch += frameEnd - frameStart;
+        if (frameEnd - _windowStart >= std::chrono::seconds(1)) {
+            _stats.framesPerSecond = _windowFrames;
+            _stats.callbacksPerSecond = _windowCallbacks;
+            _stats.dispatchTimePerSecond = _windowDispatch;
+            _windowFrames = 0;
+            _windowCallbacks = 0;
+            _windowDispatch = std::chrono::nanoseconds(0);
+            _windowStart = frameEnd;
+        }
+
+        if (_wakeRequested) {
+            interval = _busyInterval;
+        }
+        _stats.currentInterval = interval;
+        _wakeup.wait_until(lock, frameStart + interval, [this]() { return _stopRequested || _wakeRequested; });
+        if (_stopRequested) {
+            return;
+        }
+        if (_wakeRequested) {
+            _wakeRequested = false;
+            interval = _busyInterval;
+        }
+    }
+}
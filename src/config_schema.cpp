@@ -0,0 +1,30 @@
+#include "config_schema.hpp"
+
+namespace ConfigSchema {
+
+std::string DefaultConfigText() {
+    std::string text;
+    std::string_view section;
+    for (const KeyInfo& info : kKeys) {
+        if (info.section != section) {
+            if (!text.empty()) text += '\n';
+            text.append("[").append(info.section).append("]\n");
+            section = info.section;
+        } else if (!info.comment.empty()) {
+            // A commented key starts a new group, keys without one belong with the key above
+            text += '\n';
+        }
+
+        size_t start = 0;
+        while (start < info.comment.size()) {
+            size_t end = info.comment.find('\n', start);
+            if (end == std::string_view::npos) end = info.comment.size();
+            text.append("# ").append(info.comment.substr(start, end - start)).append("\n");
+            start = end + 1;
+        }
+        text.append(info.name).append(" = ").append(info.defaultValue).append("\n");
+    }
+    return text;
+}
+
+} // namespace ConfigSchema
@@ -0,0 +1,75 @@
+#include "config_watcher.hpp"
+#include <fstream>
+#include <iostream>
+
+namespace {
+    bool ReadWholeFile(const std::string& path, std::string& contents) {
+        std::ifstream file(PathUtils::ToPath(path), std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+        contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return true;
+    }
+
+    // FNV-1a, only used to tell whether the bytes changed
+    uint64_t HashContents(const std::string& contents) {
+        uint64_t hash = 14695981039346656037ull;
+        for (unsigned char c : contents) {
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+}
+
+ConfigWatcher::ConfigWatcher(const std::string& iniFilePath)
+    : _iniFilePath(PathUtils::ResolveRelativeToExecutable(iniFilePath)) {
+    std::string contents;
+    ReadWholeFile(_iniFilePath, contents);
+    _contentHash = HashContents(contents);
+    _snapshot = std::make_shared<const IniConfig>(_iniFilePath, std::move(contents));
+
+    _watcher = std::make_unique<FileWatcher>(_iniFilePath, [this] { Reload(); });
+}
+
+ConfigWatcher::~ConfigWatcher() {
+    // Join the thread before the listeners and snapshot it uses are destroyed
+    _watcher.reset();
+}
+
+std::shared_ptr<const IniConfig> ConfigWatcher::GetSnapshot() const {
+    return std::atomic_load(&_snapshot);
+}
+
+uint64_t ConfigWatcher::GetVersion() const {
+    return _version.load(std::memory_order_acquire);
+}
+
+void ConfigWatcher::Subscribe(Listener listener) {
+    std::lock_guard<std::mutex> lock(_listenersLock);
+    _listeners.push_back(std::move(listener));
+}
+
+bool ConfigWatcher::IsWatching() const {
+    return _watcher && _watcher->IsWatching();
+}
+
+void ConfigWatcher::Reload() {
+    std::string contents;
+    // Deleted or mid-replace, keep the last good snapshot
+    if (!ReadWholeFile(_iniFilePath, contents)) return;
+
+    uint64_t hash = HashContents(contents);
+    if (hash == _contentHash) return;
+    _contentHash = hash;
+
+    auto snapshot = std::make_shared<const IniConfig>(_iniFilePath, std::move(contents));
+    std::atomic_store(&_snapshot, snapshot);
+    _version.fetch_add(1, std::memory_order_release);
+
+    std::lock_guard<std::mutex> lock(_listenersLock);
+    for (const Listener& listener : _listeners) {
+        listener(*snapshot);
+    }
+}
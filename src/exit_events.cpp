@@ -0,0 +1,346 @@
+#include "exit_events.hpp"
+#include <atomic>
+#include <iostream>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+const char* ExitReasonName(ExitReason reason) {
+    switch (reason) {
+        case ExitReason::None: return "none";
+        case ExitReason::GameExited: return "game exited";
+        case ExitReason::Timeout: return "timeout";
+        case ExitReason::Signal: return "signal";
+        case ExitReason::Requested: return "requested";
+    }
+    return "unknown";
+}
+
+namespace {
+    // Whoever called ListenForSignals, signal handlers can't be handed a pointer any other way
+    std::atomic<ExitEvents*> g_signalTarget{nullptr};
+}
+
+#ifdef _WIN32
+
+class ExitEvents::Backend {
+public:
+    explicit Backend(ExitEvents& events) : _events(events) {
+        _stopEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+    }
+
+    ~Backend() {
+        if (_listening) {
+            SetConsoleCtrlHandler(&Backend::ConsoleHandler, FALSE);
+        }
+        if (_stopEvent) {
+            SetEvent(_stopEvent);
+        }
+        if (_watcher.joinable()) {
+            _watcher.join();
+        }
+        if (_process) CloseHandle(_process);
+        if (_stopEvent) CloseHandle(_stopEvent);
+    }
+
+    bool ListenForSignals() {
+        if (_listening) {
+            return true;
+        }
+        if (!s_shutdownDone) {
+            s_shutdownDone = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+        } else {
+            ResetEvent(s_shutdownDone);
+        }
+        _listening = SetConsoleCtrlHandler(&Backend::ConsoleHandler, TRUE) != FALSE;
+        return _listening;
+    }
+
+    void ShutdownComplete() {
+        if (s_shutdownDone) {
+            SetEvent(s_shutdownDone);
+        }
+    }
+
+    bool WatchProcess(uint32_t processId) {
+        if (_process || !_stopEvent) {
+            return false;
+        }
+        _process = OpenProcess(SYNCHRONIZE, FALSE, processId);
+        if (!_process) {
+            // Already gone (or never ours), either way there is nothing left to wait for
+            _events.Notify(ExitReason::GameExited);
+            return true;
+        }
+        _watcher = std::thread([this]() {
+            HANDLE handles[2] = { _process, _stopEvent };
+            if (WaitForMultipleObjects(2, handles, FALSE, INFINITE) == WAIT_OBJECT_0) {
+                _events.Notify(ExitReason::GameExited);
+            }
+        });
+        return true;
+    }
+
+private:
+    ExitEvents& _events;
+    HANDLE _stopEvent = nullptr;
+    HANDLE _process = nullptr;
+    std::thread _watcher;
+    bool _listening = false;
+
+    // Set by ShutdownComplete(). Never closed, a handler may still be waiting on it while
+    // the ExitEvents goes away
+    static HANDLE s_shutdownDone;
+    // Windows ends the process by itself about 5 seconds after a close, logoff or shutdown
+    static const DWORD kCloseGraceMs = 5000;
+
+    // Runs on a thread Windows starts for it
+    static BOOL WINAPI ConsoleHandler(DWORD type) {
+        switch (type) {
+            case CTRL_C_EVENT:
+            case CTRL_BREAK_EVENT:
+                if (ExitEvents* events = g_signalTarget.load()) {
+                    events->Notify(ExitReason::Signal);
+                    return TRUE;
+                }
+                return FALSE;
+            case CTRL_CLOSE_EVENT:
+            case CTRL_LOGOFF_EVENT:
+            case CTRL_SHUTDOWN_EVENT:
+                // The process is killed as soon as this returns, so hold on until the main
+                // thread has shut Steam down and flushed the log
+                if (ExitEvents* events = g_signalTarget.load()) {
+                    HANDLE done = s_shutdownDone;
+                    events->Notify(ExitReason::Signal);
+                    if (done) {
+                        WaitForSingleObject(done, kCloseGraceMs);
+                    }
+                    return TRUE;
+                }
+                return FALSE;
+            default:
+                return FALSE;
+        }
+    }
+};
+
+HANDLE ExitEvents::Backend::s_shutdownDone = nullptr;
+
+#else
+
+// Signal handlers only write the signal number into a pipe, a thread reads it and does
+// the actual work outside of signal context. Byte 0 tells that thread to stop.
+class ExitEvents::Backend {
+public:
+    explicit Backend(ExitEvents& events) : _events(events) {
+    }
+
+    ~Backend() {
+        if (_listening) {
+            sigaction(SIGINT, &_previous[0], nullptr);
+            sigaction(SIGTERM, &_previous[1], nullptr);
+            sigaction(SIGHUP, &_previous[2], nullptr);
+            sigaction(SIGCHLD, &_previous[3], nullptr);
+            s_pipe = -1;
+        }
+        if (_pipe[1] >= 0) {
+            char stop = 0;
+            while (write(_pipe[1], &stop, 1) < 0 && errno == EINTR) {
+            }
+        }
+        if (_reader.joinable()) {
+            _reader.join();
+        }
+        if (_pipe[0] >= 0) close(_pipe[0]);
+        if (_pipe[1] >= 0) close(_pipe[1]);
+    }
+
+    bool ListenForSignals() {
+        if (_listening) {
+            return true;
+        }
+        if (!OpenPipe()) {
+            return false;
+        }
+        s_pipe = _pipe[1];
+
+        struct sigaction action = {};
+        action.sa_handler = &Backend::SignalHandler;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_RESTART;
+        sigaction(SIGINT, &action, &_previous[0]);
+        sigaction(SIGTERM, &action, &_previous[1]);
+        sigaction(SIGHUP, &action, &_previous[2]);
+        action.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+        sigaction(SIGCHLD, &action, &_previous[3]);
+        _listening = true;
+        return true;
+    }
+
+    void ShutdownComplete() {
+        // Signals can't hold the process up, nothing waits for this
+    }
+
+    bool WatchProcess(uint32_t processId) {
+        // SIGCHLD only reaches us through ListenForSignals
+        if (!_listening) {
+            return false;
+        }
+        _child = static_cast<pid_t>(processId);
+        // It may have exited before the handler was there to see it
+        CheckChild();
+        return true;
+    }
+
+private:
+    ExitEvents& _events;
+    int _pipe[2] = { -1, -1 };
+    std::thread _reader;
+    struct sigaction _previous[4] = {};
+    bool _listening = false;
+    std::atomic<pid_t> _child{0};
+
+    static volatile sig_atomic_t s_pipe;
+
+    static void SignalHandler(int signal) {
+        int savedErrno = errno;
+        int fd = s_pipe;
+        if (fd >= 0) {
+            char byte = static_cast<char>(signal);
+            ssize_t ignored = write(fd, &byte, 1);
+            (void)ignored;
+        }
+        errno = savedErrno;
+    }
+
+    bool OpenPipe() {
+        if (_pipe[0] >= 0) {
+            return true;
+        }
+        if (pipe(_pipe) != 0) {
+            std::cerr << "Could not create the signal pipe (" << errno << ")" << std::endl;
+            return false;
+        }
+        for (int fd : _pipe) {
+            fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+        // A full pipe just drops the signal, the handler must never block
+        fcntl(_pipe[1], F_SETFL, fcntl(_pipe[1], F_GETFL) | O_NONBLOCK);
+        _reader = std::thread([this]() { Read(); });
+        return true;
+    }
+
+    void Read() {
+        char byte = 0;
+        for (;;) {
+            ssize_t got = read(_pipe[0], &byte, 1);
+            if (got < 0 && errno == EINTR) continue;
+            if (got != 1 || byte == 0) return;
+            if (byte == SIGCHLD) {
+                CheckChild();
+            } else {
+                _events.Notify(ExitReason::Signal);
+            }
+        }
+    }
+
+    void CheckChild() {
+        pid_t child = _child.load();
+        if (child <= 0) {
+            return;
+        }
+        int status = 0;
+        pid_t result = waitpid(child, &status, WNOHANG);
+        if (result == child || (result < 0 && errno == ECHILD)) {
+            _child = 0;
+            _events.Notify(ExitReason::GameExited);
+        }
+    }
+};
+
+volatile sig_atomic_t ExitEvents::Backend::s_pipe = -1;
+
+#endif
+
+ExitEvents::ExitEvents() : _backend(std::make_unique<Backend>(*this)) {
+}
+
+ExitEvents::~ExitEvents() {
+    ExitEvents* self = this;
+    g_signalTarget.compare_exchange_strong(self, nullptr);
+    _backend.reset();
+}
+
+bool ExitEvents::ListenForSignals() {
+    ExitEvents* expected = nullptr;
+    if (!g_signalTarget.compare_exchange_strong(expected, this) && expected != this) {
+        return false;
+    }
+    if (!_backend->ListenForSignals()) {
+        g_signalTarget = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool ExitEvents::WatchProcess(uint32_t processId) {
+    return processId != 0 && _backend->WatchProcess(processId);
+}
+
+void ExitEvents::ShutdownComplete() {
+    _backend->ShutdownComplete();
+}
+
+void ExitEvents::Notify(ExitReason reason) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_reason != ExitReason::None) {
+            return;
+        }
+        _reason = reason;
+    }
+    _condition.notify_all();
+}
+
+void ExitEvents::Wake() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _woken = true;
+    }
+    _condition.notify_all();
+}
+
+ExitReason ExitEvents::Wait(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    auto happened = [this]() { return _reason != ExitReason::None || _woken; };
+    if (timeout.count() > 0) {
+        if (!_condition.wait_for(lock, timeout, happened)) {
+            _reason = ExitReason::Timeout;
+        }
+    } else {
+        _condition.wait(lock, happened);
+    }
+    _woken = false;
+    return _reason;
+}
+
+ExitReason ExitEvents::WaitAtMost(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _condition.wait_for(lock, timeout, [this]() { return _reason != ExitReason::None || _woken; });
+    _woken = false;
+    return _reason;
+}
+
+ExitReason ExitEvents::GetReason() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _reason;
+}
@@ -0,0 +1,290 @@
+#include "file_watcher.hpp"
+#include "path_utils.hpp"
+#include <filesystem>
+#include <iostream>
+#include <string_view>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <cerrno>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#else
+#include <condition_variable>
+#include <mutex>
+#endif
+
+namespace {
+    enum class WaitResult {
+        Changed,
+        Timeout,
+        Stopped
+    };
+}
+
+#if defined(_WIN32)
+
+// ReadDirectoryChangesW on the parent directory, so we can tell our file apart
+// from the log files that usually sit right next to it
+class FileWatcher::Backend {
+public:
+    explicit Backend(const std::string& path) {
+        std::filesystem::path file = PathUtils::ToPath(path);
+        std::filesystem::path directory = file.has_parent_path() ? file.parent_path() : std::filesystem::path(".");
+        _name = file.filename().wstring();
+
+        _directory = CreateFileW(directory.wstring().c_str(), FILE_LIST_DIRECTORY,
+                                 FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                                 FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+        _changeEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+        _stopEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+        _valid = _directory != INVALID_HANDLE_VALUE && _changeEvent && _stopEvent && Arm();
+        if (!_valid) {
+            std::cerr << "Could not watch " << path << " for changes (" << GetLastError() << ")" << std::endl;
+        }
+    }
+
+    ~Backend() {
+        if (_directory != INVALID_HANDLE_VALUE) {
+            CancelIo(_directory);
+            CloseHandle(_directory);
+        }
+        if (_changeEvent) CloseHandle(_changeEvent);
+        if (_stopEvent) CloseHandle(_stopEvent);
+    }
+
+    bool IsValid() const { return _valid; }
+
+    WaitResult Wait(int timeoutMs) {
+        ULONGLONG deadline = GetTickCount64() + (timeoutMs < 0 ? 0 : timeoutMs);
+        for (;;) {
+            DWORD remaining = INFINITE;
+            if (timeoutMs >= 0) {
+                ULONGLONG now = GetTickCount64();
+                remaining = now >= deadline ? 0 : static_cast<DWORD>(deadline - now);
+            }
+            HANDLE handles[] = {_stopEvent, _changeEvent};
+            DWORD result = WaitForMultipleObjects(2, handles, FALSE, remaining);
+            if (result == WAIT_OBJECT_0) return WaitResult::Stopped;
+            if (result == WAIT_TIMEOUT) return WaitResult::Timeout;
+            if (result != WAIT_OBJECT_0 + 1) return WaitResult::Stopped;
+
+            DWORD bytes = 0;
+            bool completed = GetOverlappedResult(_directory, &_overlapped, &bytes, FALSE) != 0;
+            bool ours = !completed || bytes == 0 || Matches(bytes); // overflowed buffer, assume it was us
+            if (!Arm()) return WaitResult::Stopped;
+            if (ours) return WaitResult::Changed;
+        }
+    }
+
+    void Stop() {
+        if (_stopEvent) SetEvent(_stopEvent);
+    }
+
+private:
+    HANDLE _directory = INVALID_HANDLE_VALUE;
+    HANDLE _changeEvent = nullptr;
+    HANDLE _stopEvent = nullptr;
+    OVERLAPPED _overlapped = {};
+    alignas(DWORD) char _buffer[16384];
+    std::wstring _name;
+    bool _valid = false;
+
+    bool Arm() {
+        ResetEvent(_changeEvent);
+        _overlapped = {};
+        _overlapped.hEvent = _changeEvent;
+        DWORD filter = FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE;
+        return ReadDirectoryChangesW(_directory, _buffer, sizeof(_buffer), FALSE, filter, nullptr, &_overlapped, nullptr) != 0;
+    }
+
+    bool Matches(DWORD bytes) const {
+        size_t offset = 0;
+        while (offset < bytes) {
+            const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(_buffer + offset);
+            std::wstring_view name(info->FileName, info->FileNameLength / sizeof(WCHAR));
+            if (CompareStringOrdinal(name.data(), static_cast<int>(name.size()), _name.c_str(), static_cast<int>(_name.size()), TRUE) == CSTR_EQUAL) {
+                return true;
+            }
+            if (info->NextEntryOffset == 0) break;
+            offset += info->NextEntryOffset;
+        }
+        return false;
+    }
+};
+
+#elif defined(__linux__)
+
+// inotify on the parent directory, an eventfd wakes the thread up for shutdown
+class FileWatcher::Backend {
+public:
+    explicit Backend(const std::string& path) {
+        std::filesystem::path file = PathUtils::ToPath(path);
+        std::filesystem::path directory = file.has_parent_path() ? file.parent_path() : std::filesystem::path(".");
+        _name = file.filename().string();
+
+        _inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        _stop = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (_inotify >= 0) {
+            _watch = inotify_add_watch(_inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE | IN_DELETE);
+        }
+        if (_inotify < 0 || _stop < 0 || _watch < 0) {
+            std::cerr << "Could not watch " << path << " for changes (" << errno << ")" << std::endl;
+        }
+    }
+
+    ~Backend() {
+        if (_inotify >= 0) close(_inotify);
+        if (_stop >= 0) close(_stop);
+    }
+
+    bool IsValid() const { return _inotify >= 0 && _stop >= 0 && _watch >= 0; }
+
+    WaitResult Wait(int timeoutMs) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs < 0 ? 0 : timeoutMs);
+        for (;;) {
+            int remaining = -1;
+            if (timeoutMs >= 0) {
+                auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+                remaining = left < 0 ? 0 : static_cast<int>(left);
+            }
+            pollfd fds[2] = {{_stop, POLLIN, 0}, {_inotify, POLLIN, 0}};
+            int result = poll(fds, 2, remaining);
+            if (result < 0) {
+                if (errno == EINTR) continue;
+                return WaitResult::Stopped;
+            }
+            if (result == 0) return WaitResult::Timeout;
+            if (fds[0].revents) return WaitResult::Stopped;
+            if (ReadEvents()) return WaitResult::Changed;
+        }
+    }
+
+    void Stop() {
+        if (_stop >= 0) {
+            uint64_t one = 1;
+            ssize_t ignored = write(_stop, &one, sizeof(one));
+            (void)ignored;
+        }
+    }
+
+private:
+    int _inotify = -1;
+    int _stop = -1;
+    int _watch = -1;
+    std::string _name;
+
+    // True if any of the queued events were about our file
+    bool ReadEvents() {
+        alignas(inotify_event) char buffer[4096];
+        bool ours = false;
+        for (;;) {
+            ssize_t length = read(_inotify, buffer, sizeof(buffer));
+            if (length <= 0) break;
+            for (ssize_t offset = 0; offset < length;) {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                if (event->mask & IN_Q_OVERFLOW) ours = true;
+                if (event->len > 0 && _name == event->name) ours = true;
+                offset += sizeof(inotify_event) + event->len;
+            }
+        }
+        return ours;
+    }
+};
+
+#else
+
+// No native notification here, compare size and modification time twice a second
+class FileWatcher::Backend {
+public:
+    explicit Backend(const std::string& path) : _path(PathUtils::ToPath(path)) {
+        Sample(_lastTime, _lastSize);
+    }
+
+    bool IsValid() const { return true; }
+
+    WaitResult Wait(int timeoutMs) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs < 0 ? 0 : timeoutMs);
+        std::unique_lock<std::mutex> lock(_mutex);
+        for (;;) {
+            auto step = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+            if (timeoutMs >= 0 && deadline < step) step = deadline;
+            if (_wake.wait_until(lock, step, [this] { return _stopped; })) return WaitResult::Stopped;
+
+            std::filesystem::file_time_type time;
+            uintmax_t size = 0;
+            Sample(time, size);
+            if (time != _lastTime || size != _lastSize) {
+                _lastTime = time;
+                _lastSize = size;
+                return WaitResult::Changed;
+            }
+            if (timeoutMs >= 0 && std::chrono::steady_clock::now() >= deadline) return WaitResult::Timeout;
+        }
+    }
+
+    void Stop() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopped = true;
+        }
+        _wake.notify_all();
+    }
+
+private:
+    std::filesystem::path _path;
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    bool _stopped = false;
+    std::filesystem::file_time_type _lastTime;
+    uintmax_t _lastSize = 0;
+
+    void Sample(std::filesystem::file_time_type& time, uintmax_t& size) const {
+        std::error_code ec;
+        time = std::filesystem::last_write_time(_path, ec);
+        size = std::filesystem::file_size(_path, ec);
+    }
+};
+
+#endif
+
+FileWatcher::FileWatcher(const std::string& path, std::function<void()> onChange, std::chrono::milliseconds debounce)
+    : _backend(std::make_unique<Backend>(path)), _onChange(std::move(onChange)), _debounce(debounce) {
+    if (_backend->IsValid()) {
+        _thread = std::thread(&FileWatcher::Run, this);
+    }
+}
+
+FileWatcher::~FileWatcher() {
+    if (_thread.joinable()) {
+        _backend->Stop();
+        _thread.join();
+    }
+}
+
+bool FileWatcher::IsWatching() const {
+    return _thread.joinable();
+}
+
+void FileWatcher::Run() {
+    for (;;) {
+        WaitResult result = _backend->Wait(-1);
+        if (result == WaitResult::Stopped) return;
+        if (result != WaitResult::Changed) continue;
+
+        // Editors (and our own saves) touch the file several times in a row, wait for them to finish
+        do {
+            result = _backend->Wait(static_cast<int>(_debounce.count()));
+            if (result == WaitResult::Stopped) return;
+        } while (result == WaitResult::Changed);
+
+        try {
+            _onChange();
+        } catch (const std::exception& ex) {
+            std::cerr << "Error handling change to watched file: " << ex.what() << std::endl;
+        }
+    }
+}
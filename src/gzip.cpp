@@ -0,0 +1,225 @@
+#include "gzip.hpp"
+#include "path_utils.hpp"
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iterator>
+
+namespace {
+    constexpr size_t kWindowSize = 32768;
+    constexpr size_t kMinMatch = 3;
+    constexpr size_t kMaxMatch = 258;
+    constexpr size_t kMaxChain = 64;
+    constexpr size_t kHashBits = 15;
+    constexpr size_t kHashSize = size_t(1) << kHashBits;
+
+    const uint16_t kLengthBase[29] = {
+        3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+        35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+    };
+    const uint8_t kLengthExtra[29] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+        3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+    };
+    const uint16_t kDistanceBase[30] = {
+        1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+        257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+    };
+    const uint8_t kDistanceExtra[30] = {
+        0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+        7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+    };
+
+    class BitWriter {
+    public:
+        explicit BitWriter(std::vector<uint8_t>& out) : _out(out) {}
+
+        // DEFLATE packs values starting at the least significant bit
+        void Write(uint32_t value, int bits) {
+            _buffer |= value << _count;
+            _count += bits;
+            while (_count >= 8) {
+                _out.push_back(static_cast<uint8_t>(_buffer));
+                _buffer >>= 8;
+                _count -= 8;
+            }
+        }
+
+        // Huffman codes are defined most significant bit first
+        void WriteCode(uint32_t code, int bits) {
+            uint32_t reversed = 0;
+            for (int i = 0; i < bits; i++) {
+                reversed = (reversed << 1) | ((code >> i) & 1);
+            }
+            Write(reversed, bits);
+        }
+
+        void Finish() {
+            if (_count > 0) {
+                _out.push_back(static_cast<uint8_t>(_buffer));
+            }
+            _buffer = 0;
+            _count = 0;
+        }
+
+    private:
+        std::vector<uint8_t>& _out;
+        uint32_t _buffer = 0;
+        int _count = 0;
+    };
+
+    void WriteLiteral(BitWriter& bits, uint32_t symbol) {
+        if (symbol <= 143) {
+            bits.WriteCode(0x30 + symbol, 8);
+        } else if (symbol <= 255) {
+            bits.WriteCode(0x190 + (symbol - 144), 9);
+        } else if (symbol <= 279) {
+            bits.WriteCode(symbol - 256, 7);
+        } else {
+            bits.WriteCode(0xC0 + (symbol - 280), 8);
+        }
+    }
+
+    void WriteMatch(BitWriter& bits, size_t length, size_t distance) {
+        int lengthCode = 28;
+        while (kLengthBase[lengthCode] > length) {
+            lengthCode--;
+        }
+        WriteLiteral(bits, 257 + lengthCode);
+        bits.Write(static_cast<uint32_t>(length - kLengthBase[lengthCode]), kLengthExtra[lengthCode]);
+
+        int distanceCode = 29;
+        while (kDistanceBase[distanceCode] > distance) {
+            distanceCode--;
+        }
+        bits.WriteCode(distanceCode, 5);
+        bits.Write(static_cast<uint32_t>(distance - kDistanceBase[distanceCode]), kDistanceExtra[distanceCode]);
+    }
+
+    uint32_t Hash3(const uint8_t* p) {
+        uint32_t value = (uint32_t(p[0]) << 16) | (uint32_t(p[1]) << 8) | p[2];
+        return (value * 2654435761u) >> (32 - kHashBits);
+    }
+
+    uint32_t Crc32(const uint8_t* data, size_t size) {
+        static const std::array<uint32_t, 256> table = [] {
+            std::array<uint32_t, 256> t{};
+            for (uint32_t i = 0; i < 256; i++) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; k++) {
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                }
+                t[i] = c;
+            }
+            return t;
+        }();
+
+        uint32_t crc = 0xFFFFFFFFu;
+        for (size_t i = 0; i < size; i++) {
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    void WriteLE32(std::vector<uint8_t>& out, uint32_t value) {
+        for (int i = 0; i < 4; i++) {
+            out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    }
+}
+
+std::vector<uint8_t> Gzip::Compress(const uint8_t* data, size_t size) {
+    std::vector<uint8_t> out;
+    out.reserve(size / 3 + 64);
+
+    // gzip header: magic, deflate, no flags, no mtime, no extra flags, unknown OS
+    const uint8_t header[10] = { 0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 0xff };
+    out.insert(out.end(), std::begin(header), std::end(header));
+
+    BitWriter bits(out);
+    bits.Write(1, 1); // final block
+    bits.Write(1, 2); // fixed Huffman codes
+
+    std::vector<int32_t> head(kHashSize, -1);
+    std::vector<int32_t> previous(kWindowSize, -1);
+
+    size_t pos = 0;
+    while (pos < size) {
+        size_t bestLength = 0;
+        size_t bestDistance = 0;
+
+        if (pos + kMinMatch <= size) {
+            uint32_t hash = Hash3(data + pos);
+            int32_t candidate = head[hash];
+            size_t maxLength = std::min(kMaxMatch, size - pos);
+            for (size_t chain = 0; chain < kMaxChain && candidate >= 0; chain++) {
+                size_t distance = pos - static_cast<size_t>(candidate);
+                if (distance > kWindowSize) break;
+
+                const uint8_t* a = data + candidate;
+                const uint8_t* b = data + pos;
+                if (a[bestLength] == b[bestLength]) {
+                    size_t length = 0;
+                    while (length < maxLength && a[length] == b[length]) {
+                        length++;
+                    }
+                    if (length > bestLength) {
+                        bestLength = length;
+                        bestDistance = distance;
+                        if (length == maxLength) break;
+                    }
+                }
+                int32_t next = previous[candidate % kWindowSize];
+                if (next >= candidate) break;
+                candidate = next;
+            }
+            previous[pos % kWindowSize] = head[hash];
+            head[hash] = static_cast<int32_t>(pos);
+        }
+
+        if (bestLength >= kMinMatch) {
+            WriteMatch(bits, bestLength, bestDistance);
+            // Keep the hash chains up to date for the bytes we skipped over
+            for (size_t i = 1; i < bestLength; i++) {
+                size_t p = pos + i;
+                if (p + kMinMatch <= size) {
+                    uint32_t hash = Hash3(data + p);
+                    previous[p % kWindowSize] = head[hash];
+                    head[hash] = static_cast<int32_t>(p);
+                }
+            }
+            pos += bestLength;
+        } else {
+            WriteLiteral(bits, data[pos]);
+            pos++;
+        }
+    }
+
+    WriteLiteral(bits, 256); // end of block
+    bits.Finish();
+
+    WriteLE32(out, Crc32(data, size));
+    WriteLE32(out, static_cast<uint32_t>(size));
+    return out;
+}
+
+bool Gzip::CompressFile(const std::string& sourcePath, const std::string& destinationPath) {
+    std::ifstream input(PathUtils::ToPath(sourcePath), std::ios::binary);
+    if (!input.is_open()) {
+        return false;
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    if (input.bad()) {
+        return false;
+    }
+
+    std::vector<uint8_t> compressed = Compress(data.data(), data.size());
+
+    std::ofstream output(PathUtils::ToPath(destinationPath), std::ios::binary | std::ios::trunc);
+    if (!output.is_open()) {
+        return false;
+    }
+    output.write(reinterpret_cast<const char*>(compressed.data()), compressed.size());
+    output.close();
+    return !output.fail();
+}
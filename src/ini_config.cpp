@@ -1,156 +1,430 @@
 #include "ini_config.hpp"
 #include <fstream>
-#include <sstream>
 #include <iostream>
 #include <algorithm>
 
-IniConfig::IniConfig(const std::string& iniFilePath) : _iniFilePath(PathUtils::ResolveRelativeToExecutable(iniFilePath)) {
+IniConfig::IniConfig(const std::string& iniFilePath, std::shared_ptr<FileWriter> writer)
+    : _iniFilePath(PathUtils::ResolveRelativeToExecutable(iniFilePath)),
+      _writer(writer ? std::move(writer) : AtomicFileWriter::Default()),
+      _slots(64, 0) {
     LoadConfig();
 }
 
+IniConfig::IniConfig(const std::string& iniFilePath, std::string contents, std::shared_ptr<FileWriter> writer)
+    : _iniFilePath(PathUtils::ResolveRelativeToExecutable(iniFilePath)),
+      _writer(writer ? std::move(writer) : AtomicFileWriter::Default()),
+      _buffer(std::move(contents)),
+      _slots(64, 0) {
+    Parse();
+}
+
+namespace {
+    bool IsSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+    }
+
+    std::string_view Trim(std::string_view text) {
+        size_t start = 0;
+        while (start < text.size() && IsSpace(text[start])) start++;
+        size_t end = text.size();
+        while (end > start && IsSpace(text[end - 1])) end--;
+        return text.substr(start, end - start);
+    }
+}
+
 void IniConfig::LoadConfig() {
-    _configData.clear();
+    Clear();
 
-    std::ifstream file(_iniFilePath);
-    if (!file.is_open()) {
+    if (!ReadFile(_buffer)) {
         CreateDefaultConfig();
         return;
     }
+    Parse();
+
+    for (const std::string& error : _settings.GetErrors()) {
+        std::cerr << "Config error in " << _iniFilePath << ": " << error << std::endl;
+    }
+}
+
+bool IniConfig::ReadFile(std::string& contents) const {
+    // One read for the whole file, everything after this works on views into the buffer
+    std::ifstream file(PathUtils::ToPath(_iniFilePath), std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::streamoff size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    contents.resize(size > 0 ? static_cast<size_t>(size) : 0);
+    if (size > 0) {
+        file.read(&contents[0], size);
+        contents.resize(static_cast<size_t>(file.gcount()));
+    }
+    return true;
+}
+
+void IniConfig::Parse() {
+    _settings = LauncherSettings();
+    _lines.clear();
+    _ownedStrings.clear();
+    _entries.clear();
+    _sections.clear();
+    _slots.assign(64, 0);
+    _dirty = false;
+
+    std::string_view text(_buffer);
+    _crlf = text.find("\r\n") != std::string_view::npos;
 
-    std::string line;
-    std::string currentSection;
-    while (std::getline(file, line)) {
-        // Trim whitespace
-        line.erase(line.begin(), std::find_if(line.begin(), line.end(), [](unsigned char ch) { return !std::isspace(ch); }));
-        line.erase(std::find_if(line.rbegin(), line.rend(), [](unsigned char ch) { return !std::isspace(ch); }).base(), line.end());
+    Section* currentSection = nullptr;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find('\n', pos);
+        if (end == std::string_view::npos) end = text.size();
+        std::string_view raw = text.substr(pos, end - pos);
+        std::string_view line = Trim(raw);
+        pos = end + 1;
+
+        size_t lineIndex = _lines.size();
+        _lines.push_back(raw);
+
+        // Notepad likes to start the file with a UTF-8 BOM. It stays in the line so saving keeps it,
+        // but it mustn't hide the first section header
+        if (lineIndex == 0 && line.substr(0, 3) == "\xEF\xBB\xBF") {
+            line = Trim(line.substr(3));
+        }
 
         if (line.empty() || line[0] == ';' || line[0] == '#') continue;
 
         if (line[0] == '[' && line.back() == ']') {
-            currentSection = line.substr(1, line.size() - 2);
-            _configData[currentSection];
-        } else if (!currentSection.empty()) {
+            std::string_view name = line.substr(1, line.size() - 2);
+            currentSection = name.empty() ? nullptr : &AddSection(name);
+            if (currentSection) {
+                currentSection->lastLine = lineIndex;
+            }
+        } else if (currentSection) {
+            // Keys above the first section header (or under "[]") are kept as text but never read
             size_t equalsPos = line.find('=');
-            if (equalsPos != std::string::npos) {
-                std::string key = line.substr(0, equalsPos);
-                std::string value = line.substr(equalsPos + 1);
-                // Trim key and value
-                key.erase(key.begin(), std::find_if(key.begin(), key.end(), [](unsigned char ch) { return !std::isspace(ch); }));
-                key.erase(std::find_if(key.rbegin(), key.rend(), [](unsigned char ch) { return !std::isspace(ch); }).base(), key.end());
-                value.erase(value.begin(), std::find_if(value.begin(), value.end(), [](unsigned char ch) { return !std::isspace(ch); }));
-                value.erase(std::find_if(value.rbegin(), value.rend(), [](unsigned char ch) { return !std::isspace(ch); }).base(), value.end());
-                _configData[currentSection][key] = value;
+            if (equalsPos != std::string_view::npos) {
+                std::string_view key = Trim(line.substr(0, equalsPos));
+                std::string_view value = Trim(line.substr(equalsPos + 1));
+                size_t index = Insert(currentSection->name, key, value);
+                _settings.Apply(currentSection->name, key, value);
+                // Measured in the raw line, so saving only swaps the value and "Key=1", "Key = 1"
+                // or "Key = " (empty) all keep their spacing
+                size_t valueOffset = static_cast<size_t>(line.data() - raw.data()) + equalsPos + 1;
+                if (!value.empty()) {
+                    valueOffset = static_cast<size_t>(value.data() - raw.data());
+                } else {
+                    while (valueOffset < raw.size() && (raw[valueOffset] == ' ' || raw[valueOffset] == '\t')) valueOffset++;
+                }
+                _entries[index].line = lineIndex;
+                _entries[index].valueOffset = valueOffset;
+                currentSection->lastLine = lineIndex;
             }
         }
     }
 }
 
 void IniConfig::SaveConfig() {
-    std::ofstream file(_iniFilePath);
-    if (!file.is_open()) {
+    if (_transactionDepth > 0 || !_dirty) return;
+
+    FileLock lock(_iniFilePath);
+
+    // Another launcher may have saved since we loaded, put our changes on top of its file instead of over it
+    std::string onDisk;
+    if (ReadFile(onDisk) && onDisk != _buffer) {
+        std::vector<std::string> changes;
+        for (const Entry& entry : _entries) {
+            if (!entry.dirty) continue;
+            changes.emplace_back(entry.section);
+            changes.emplace_back(entry.key);
+            changes.emplace_back(entry.value);
+        }
+        _buffer = std::move(onDisk);
+        Parse();
+        for (size_t i = 0; i < changes.size(); i += 3) {
+            SetValue(changes[i], changes[i + 1], changes[i + 2]);
+        }
+        if (!_dirty) return;
+    }
+
+    std::string text = Render();
+    if (!_writer->Write(_iniFilePath, text)) {
         std::cerr << "Error saving config: " << _iniFilePath << std::endl;
         return;
     }
 
-    for (const auto& section : _configData) {
-        file << "[" << section.first << "]\n";
-        for (const auto& kvp : section.second) {
-            file << kvp.first << " = " << kvp.second << "\n";
+    // What's on disk is now the document, start over from it
+    _buffer = std::move(text);
+    Parse();
+}
+
+std::string IniConfig::Render() const {
+    const char* newline = _crlf ? "\r\n" : "\n";
+
+    // Changed values are patched into their original line, new keys go after the last line of their section
+    std::vector<size_t> changedEntry(_lines.size(), kNotFound);
+    std::vector<std::vector<size_t>> insertAfter(_lines.size());
+    std::vector<std::vector<size_t>> newSectionEntries(_sections.size());
+    for (size_t i = 0; i < _entries.size(); i++) {
+        const Entry& entry = _entries[i];
+        if (entry.line != kNotFound) {
+            if (entry.dirty) changedEntry[entry.line] = i;
+            continue;
+        }
+        for (size_t s = 0; s < _sections.size(); s++) {
+            if (_sections[s].name == entry.section) {
+                if (_sections[s].lastLine != kNotFound) {
+                    insertAfter[_sections[s].lastLine].push_back(i);
+                } else {
+                    newSectionEntries[s].push_back(i);
+                }
+                break;
+            }
         }
-        file << "\n";
     }
+
+    std::string text;
+    text.reserve(_buffer.size() + 256);
+    for (size_t line = 0; line < _lines.size(); line++) {
+        std::string_view raw = _lines[line];
+        bool hadCarriageReturn = !raw.empty() && raw.back() == '\r';
+
+        if (changedEntry[line] != kNotFound) {
+            // Every byte around the old value stays, trailing blanks and \r included
+            const Entry& entry = _entries[changedEntry[line]];
+            size_t valueEnd = raw.size();
+            while (valueEnd > entry.valueOffset && IsSpace(raw[valueEnd - 1])) valueEnd--;
+            text.append(raw.substr(0, entry.valueOffset));
+            text.append(entry.value);
+            text.append(raw.substr(valueEnd));
+        } else {
+            text.append(raw);
+        }
+
+        // Lines keep the ending they had (a mixed file stays mixed). The last line only gets
+        // a newline if it had one, or if something follows it now
+        if (line + 1 < _lines.size() || _buffer.back() == '\n') {
+            text.push_back('\n');
+        } else if (!insertAfter[line].empty()) {
+            text.append(hadCarriageReturn ? "\n" : newline);
+        }
+        for (size_t index : insertAfter[line]) {
+            const Entry& entry = _entries[index];
+            text.append(entry.key).append(" = ").append(entry.value).append(newline);
+        }
+    }
+
+    for (size_t s = 0; s < _sections.size(); s++) {
+        if (_sections[s].lastLine != kNotFound) continue;
+        if (!text.empty() && text.back() != '\n') text.append(newline);
+        if (!text.empty()) text.append(newline);
+        text.append("[").append(_sections[s].name).append("]").append(newline);
+        for (size_t index : newSectionEntries[s]) {
+            const Entry& entry = _entries[index];
+            text.append(entry.key).append(" = ").append(entry.value).append(newline);
+        }
+    }
+    return text;
 }
 
-std::string IniConfig::GetValue(const std::string& section, const std::string& key, const std::string& defaultValue) const {
-    auto secIt = _configData.find(section);
-    if (secIt != _configData.end()) {
-        auto keyIt = secIt->second.find(key);
-        if (keyIt != secIt->second.end()) {
-            return keyIt->second;
+std::string IniConfig::GetValue(std::string_view section, std::string_view key, std::string_view defaultValue) const {
+    return std::string(GetValueView(section, key, defaultValue));
+}
+
+std::string_view IniConfig::GetValueView(std::string_view section, std::string_view key, std::string_view defaultValue) const {
+    size_t index = Find(section, key);
+    return index != kNotFound ? _entries[index].value : defaultValue;
+}
+
+bool IniConfig::HasValue(std::string_view section, std::string_view key) const {
+    return Find(section, key) != kNotFound;
+}
+
+const std::string& IniConfig::GetFilePath() const {
+    return _iniFilePath;
+}
+
+void IniConfig::SetValue(std::string_view section, std::string_view key, std::string_view value) {
+    size_t index = Find(section, key);
+    if (index != kNotFound) {
+        if (_entries[index].value != value) {
+            _entries[index].value = Own(value);
+            _entries[index].dirty = true;
+            _dirty = true;
+            _settings.Apply(section, key, value);
+        }
+        return;
+    }
+    std::string_view ownedSection = AddSection(Own(section)).name;
+    index = Insert(ownedSection, Own(key), Own(value));
+    _entries[index].dirty = true;
+    _dirty = true;
+    _settings.Apply(section, key, value);
+}
+
+void IniConfig::SetValue(ConfigKey key, std::string_view value) {
+    const ConfigSchema::KeyInfo& info = ConfigSchema::Info(key);
+    SetValue(info.section, info.name, value);
+}
+
+const LauncherSettings& IniConfig::GetSettings() const {
+    return _settings;
+}
+
+void IniConfig::Clear() {
+    _buffer.clear();
+    _lines.clear();
+    _ownedStrings.clear();
+    _entries.clear();
+    _sections.clear();
+    _slots.assign(64, 0);
+    _dirty = false;
+}
+
+size_t IniConfig::Find(std::string_view section, std::string_view key) const {
+    if (_slots.empty()) return kNotFound;
+
+    size_t mask = _slots.size() - 1;
+    for (size_t i = Hash(section, key) & mask;; i = (i + 1) & mask) {
+        uint32_t slot = _slots[i];
+        if (slot == 0) return kNotFound;
+        const Entry& entry = _entries[slot - 1];
+        if (entry.key == key && entry.section == section) return slot - 1;
+    }
+}
+
+size_t IniConfig::Insert(std::string_view section, std::string_view key, std::string_view value) {
+    // Later duplicates win, like they did with the old map
+    size_t index = Find(section, key);
+    if (index != kNotFound) {
+        _entries[index].value = value;
+        return index;
+    }
+
+    // Keep the table at most half full so probe chains stay short
+    if ((_entries.size() + 1) * 2 > _slots.size()) {
+        Rehash(_slots.empty() ? 64 : _slots.size() * 2);
+    }
+    Entry entry;
+    entry.section = section;
+    entry.key = key;
+    entry.value = value;
+    _entries.push_back(entry);
+
+    size_t mask = _slots.size() - 1;
+    size_t i = Hash(section, key) & mask;
+    while (_slots[i] != 0) {
+        i = (i + 1) & mask;
+    }
+    _slots[i] = static_cast<uint32_t>(_entries.size());
+    return _entries.size() - 1;
+}
+
+IniConfig::Section& IniConfig::AddSection(std::string_view section) {
+    for (Section& existing : _sections) {
+        if (existing.name == section) return existing;
+    }
+    _sections.push_back({ section, kNotFound });
+    return _sections.back();
+}
+
+void IniConfig::Rehash(size_t slotCount) {
+    _slots.assign(slotCount, 0);
+    size_t mask = slotCount - 1;
+    for (size_t index = 0; index < _entries.size(); index++) {
+        size_t i = Hash(_entries[index].section, _entries[index].key) & mask;
+        while (_slots[i] != 0) {
+            i = (i + 1) & mask;
         }
+        _slots[i] = static_cast<uint32_t>(index + 1);
     }
-    return defaultValue;
 }
 
-void IniConfig::SetValue(const std::string& section, const std::string& key, const std::string& value) {
-    _configData[section][key] = value;
+std::string_view IniConfig::Own(std::string_view text) {
+    _ownedStrings.emplace_back(text);
+    return _ownedStrings.back();
 }
 
-uint32_t IniConfig::GetAppID() {
-    std::string appIdStr = GetValue("uc-online", "AppID", "0");
-    try {
-        return std::stoul(appIdStr);
-    } catch (...) {
-        return 0;
+size_t IniConfig::Hash(std::string_view section, std::string_view key) {
+    // FNV-1a over "section\0key"
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : section) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    }
+    hash = hash * 1099511628211ull;
+    for (char c : key) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
     }
+    return static_cast<size_t>(hash ^ (hash >> 32));
+}
+
+uint32_t IniConfig::GetAppID() const {
+    return _settings.Get<ConfigKey::AppID>();
 }
 
 void IniConfig::SetAppID(uint32_t appId) {
-    SetValue("uc-online", "AppID", std::to_string(appId));
+    SetValue(ConfigKey::AppID, std::to_string(appId));
 }
 
-std::string IniConfig::GetGameExecutable() {
-    return GetValue("uc-online", "GameExecutable", "");
+std::string IniConfig::GetGameExecutable() const {
+    return PathUtils::ToUtf8(_settings.Get<ConfigKey::GameExecutable>());
 }
 
 void IniConfig::SetGameExecutable(const std::string& gameExePath) {
-    SetValue("uc-online", "GameExecutable", gameExePath);
+    SetValue(ConfigKey::GameExecutable, gameExePath);
 }
 
-std::string IniConfig::GetGameArguments() {
-    return GetValue("uc-online", "GameArguments", "");
+std::string IniConfig::GetGameArguments() const {
+    return _settings.Get<ConfigKey::GameArguments>();
 }
 
 void IniConfig::SetGameArguments(const std::string& arguments) {
-    SetValue("uc-online", "GameArguments", arguments);
+    SetValue(ConfigKey::GameArguments, arguments);
 }
 
-std::string IniConfig::GetSteamApiDllPath() {
-    return GetValue("uc-online", "SteamApiDLLPath", "");
+std::string IniConfig::GetSteamApiDllPath() const {
+    return PathUtils::ToUtf8(_settings.Get<ConfigKey::SteamApiDLLPath>());
 }
 
 void IniConfig::SetSteamApiDllPath(const std::string& dllPath) {
-    SetValue("uc-online", "SteamApiDLLPath", dllPath);
-    SaveConfig();
+    SetValue(ConfigKey::SteamApiDLLPath, dllPath);
+}
+
+ConfigTransaction::ConfigTransaction(IniConfig& config) : _config(&config) {
+    _config->_transactionDepth++;
+}
+
+ConfigTransaction::ConfigTransaction(ConfigTransaction&& other) noexcept : _config(other._config) {
+    other._config = nullptr;
+}
+
+ConfigTransaction::~ConfigTransaction() {
+    Commit();
+}
+
+void ConfigTransaction::Commit() {
+    if (!_config) return;
+
+    IniConfig* config = _config;
+    _config = nullptr;
+    if (--config->_transactionDepth == 0) {
+        config->SaveConfig();
+    }
 }
 
 void IniConfig::CreateDefaultConfig() {
-    std::string defaultConfig = R"(
-[uc-online]
-# Set the appID to be used here, e.g., 730 for Counter-Strike 2)
-# (Please note that you will want to set it to a game you can get for free that is multiplayer. Anything else, and it won't work.)
-# Default appID is set to 480 (Spacewar), however you can change it to any appID you want.
-AppID = 480
-
-# Executable needs to be set directly. Unlike the dll, there is no 'default' for the exe.
-# Using UE5 games as an example, the correct launcher path will look like this:
-# game folder\game folder\Binaries\Win64\game folder-Win64-Shipping.exe
-GameExecutable = 
-
-# Set launch arguments where necessary - e.g., for Source Engine games like Half-Life: Source, set it to '-game hl1 -windowed' to launch it correctly.
-GameArguments = 
-
-# Set the path to the steam_appid.txt file to use. (If one does not exist, it will be generated with the appID set at the top.)
-SteamAppIdFile = steam_appid.txt
-
-# Path to steam_api.dll (leave empty to use default location - in the same folder next to the launcher.)
-# Only set the path as the folder containing the dll relative to the launcher.
-# Again, using UE5 games as an example:
-# game folder\Engine\Binaries\ThirdParty\Steamworks\Steamv153\Win64
-SteamApiDLLPath = 
-
-[Logging]
-# Turns on logging. Not much gets logged, so it's not exactly useful. I recommend keeping it set to false, however with it being rewritten, it seems to behave differently.
-# It doesn't give you a chance to see what the issue was if you set something incorrectly, it just closes immediately or runs for a second and then closes. 
-# If you need it, set it to true. Otherwise, there's nothing really worth logging.
-EnableLogging = false
-LogFile = uc_online.log
-)";
-
-    std::ofstream file(_iniFilePath);
-    if (file.is_open()) {
-        file << defaultConfig;
-        LoadConfig();
+    // Generated from ConfigSchema::kKeys, every key with its default and comment
+    std::string defaultConfig = ConfigSchema::DefaultConfigText();
+
+    // Two launchers started together both find no config, only the first one to get the lock writes it
+    FileLock lock(_iniFilePath);
+    if (ReadFile(_buffer)) {
+        Parse();
+        return;
+    }
+    if (_writer->Write(_iniFilePath, defaultConfig)) {
+        _buffer = std::move(defaultConfig);
+        Parse();
     } else {
         std::cerr << "Error creating default config: " << _iniFilePath << std::endl;
     }
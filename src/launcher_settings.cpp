@@ -0,0 +1,99 @@
+#include "launcher_settings.hpp"
+#include "path_utils.hpp"
+#include <charconv>
+
+namespace {
+    bool EqualsIgnoreCase(std::string_view a, std::string_view b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); i++) {
+            char x = a[i] >= 'A' && a[i] <= 'Z' ? static_cast<char>(a[i] - 'A' + 'a') : a[i];
+            if (x != b[i]) return false;
+        }
+        return true;
+    }
+
+    bool ParseBool(std::string_view value, bool& result) {
+        if (EqualsIgnoreCase(value, "true") || EqualsIgnoreCase(value, "yes") || EqualsIgnoreCase(value, "on") || value == "1") {
+            result = true;
+            return true;
+        }
+        if (EqualsIgnoreCase(value, "false") || EqualsIgnoreCase(value, "no") || EqualsIgnoreCase(value, "off") || value == "0") {
+            result = false;
+            return true;
+        }
+        return false;
+    }
+
+    bool ParseUInt32(std::string_view value, uint32_t& result) {
+        uint32_t parsed = 0;
+        auto end = std::from_chars(value.data(), value.data() + value.size(), parsed);
+        if (end.ec != std::errc() || end.ptr != value.data() + value.size()) return false;
+        result = parsed;
+        return true;
+    }
+
+    std::string ConversionError(const ConfigSchema::KeyInfo& info, std::string_view value, std::string_view expected) {
+        std::string message(info.name);
+        message.append(" = '").append(value).append("' is not ").append(expected).append(", ignoring it");
+        return message;
+    }
+}
+
+template <size_t I>
+bool LauncherSettings::Convert(LauncherSettings& settings, std::string_view value) {
+    using ConfigSchema::Type;
+    constexpr const ConfigSchema::KeyInfo& info = ConfigSchema::kKeys[I];
+    auto& slot = std::get<I>(settings._values);
+
+    if constexpr (info.type == Type::String) {
+        slot.assign(value.data(), value.size());
+        return true;
+    } else if constexpr (info.type == Type::Path) {
+        slot = PathUtils::ToPath(value);
+        return true;
+    } else {
+        // Left empty means "use the default", not an error, but nothing was set either
+        if (value.empty()) return false;
+
+        if constexpr (info.type == Type::UInt32) {
+            if (ParseUInt32(value, slot)) return true;
+            settings._errors.push_back(ConversionError(info, value, "a whole number"));
+        } else if constexpr (info.type == Type::Bool) {
+            if (ParseBool(value, slot)) return true;
+            settings._errors.push_back(ConversionError(info, value, "true or false"));
+        } else {
+            int choice = ConfigSchema::FindChoice(info.choices, value);
+            if (choice >= 0) {
+                slot = static_cast<uint8_t>(choice);
+                return true;
+            }
+            std::string expected("one of ");
+            expected.append(info.choices);
+            settings._errors.push_back(ConversionError(info, value, expected));
+        }
+        return false;
+    }
+}
+
+template <size_t... I>
+constexpr std::array<LauncherSettings::Converter, sizeof...(I)> LauncherSettings::MakeConverters(std::index_sequence<I...>) {
+    return {{&LauncherSettings::Convert<I>...}};
+}
+
+LauncherSettings::LauncherSettings() {
+    for (const ConfigSchema::KeyInfo& info : ConfigSchema::kKeys) {
+        Apply(info.id, info.defaultValue);
+    }
+}
+
+bool LauncherSettings::Apply(std::string_view section, std::string_view key, std::string_view value) {
+    ConfigKey id = ConfigSchema::Find(section, key);
+    if (id == ConfigKey::Count) return false;
+    Apply(id, value);
+    return true;
+}
+
+bool LauncherSettings::Apply(ConfigKey key, std::string_view value) {
+    static constexpr auto converters = MakeConverters(std::make_index_sequence<ConfigSchema::kKeyCount>());
+    return converters[static_cast<size_t>(key)](*this, value);
+}
@@ -0,0 +1,174 @@
+#include "layered_config.hpp"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace {
+    char ToLower(char c) {
+        return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    char ToUpper(char c) {
+        return c >= 'a' && c <= 'z' ? static_cast<char>(c - 'a' + 'A') : c;
+    }
+
+    bool EqualsIgnoreCase(std::string_view a, std::string_view b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); i++) {
+            if (ToLower(a[i]) != ToLower(b[i])) return false;
+        }
+        return true;
+    }
+
+    // Key names are unique across sections, so the name alone is enough on the command line
+    ConfigKey FindByName(std::string_view name) {
+        for (const ConfigSchema::KeyInfo& info : ConfigSchema::kKeys) {
+            if (EqualsIgnoreCase(info.name, name)) return info.id;
+        }
+        return ConfigKey::Count;
+    }
+
+    // The wide variable on Windows, getenv would hand back the ANSI version and mangle non-ASCII paths
+    bool GetEnvironment(const std::string& name, std::string& value) {
+#ifdef _WIN32
+        const wchar_t* wide = _wgetenv(std::wstring(name.begin(), name.end()).c_str());
+        if (!wide) return false;
+        value = PathUtils::ToUtf8(std::filesystem::path(wide));
+#else
+        const char* raw = std::getenv(name.c_str());
+        if (!raw) return false;
+        value = raw;
+#endif
+        return true;
+    }
+}
+
+const char* ConfigLayerName(ConfigLayer layer) {
+    switch (layer) {
+        case ConfigLayer::Default: return "default";
+        case ConfigLayer::Machine: return "machine config";
+        case ConfigLayer::Game: return "config.ini";
+        case ConfigLayer::Environment: return "environment";
+        case ConfigLayer::CommandLine: return "command line";
+    }
+    return "unknown";
+}
+
+ConfigOverrides ConfigOverrides::FromEnvironment() {
+    ConfigOverrides overrides;
+    for (const ConfigSchema::KeyInfo& info : ConfigSchema::kKeys) {
+        std::string name = "UC_ONLINE_";
+        for (char c : info.name) name += ToUpper(c);
+        std::string value;
+        if (GetEnvironment(name, value)) {
+            overrides.values.push_back(Value{ info.id, std::move(value) });
+        }
+    }
+    GetEnvironment("UC_ONLINE_CONFIG", overrides.configPath);
+    return overrides;
+}
+
+ConfigOverrides ConfigOverrides::FromCommandLine(int argc, char** argv) {
+    ConfigOverrides overrides;
+    for (int i = 1; i < argc; i++) {
+        std::string_view flag(argv[i]);
+        std::string_view arg = flag;
+        if (arg.size() < 3 || arg.substr(0, 2) != "--") {
+            overrides.unknown.emplace_back(arg);
+            continue;
+        }
+        arg.remove_prefix(2);
+
+        // --key=value, or --key value when the next argument isn't another flag
+        std::string_view name = arg;
+        std::string value;
+        size_t equals = arg.find('=');
+        bool hasValue = equals != std::string_view::npos;
+        if (hasValue) {
+            name = arg.substr(0, equals);
+            value = std::string(arg.substr(equals + 1));
+        }
+        auto takeNext = [&]() {
+            if (!hasValue && i + 1 < argc && std::string_view(argv[i + 1]).substr(0, 2) != "--") {
+                value = argv[++i];
+            }
+        };
+
+        if (EqualsIgnoreCase(name, "config")) {
+            takeNext();
+            overrides.configPath = value;
+            continue;
+        }
+        ConfigKey key = FindByName(name);
+        if (key == ConfigKey::Count) {
+            overrides.unknown.emplace_back(flag);
+            continue;
+        }
+        // A bare --watchconfig turns it on and leaves the next argument alone, that one
+        // may well be meant for the game
+        if (ConfigSchema::Info(key).type == ConfigSchema::Type::Bool) {
+            if (!hasValue) value = "true";
+        } else {
+            takeNext();
+        }
+        overrides.values.push_back(Value{ key, std::move(value) });
+    }
+    return overrides;
+}
+
+LayeredConfig::LayeredConfig(const IniConfig* machine, const IniConfig& game, const ConfigOverrides& environment,
+                             const ConfigOverrides& commandLine) {
+    for (ConfigLayer& source : _sources) {
+        source = ConfigLayer::Default;
+    }
+
+    // Lowest layer first, whatever is applied last for a key is what sticks. A generated
+    // config.ini spells out every default, so an ini only counts for keys it actually
+    // changes: empty or the schema default leaves whatever the layer below said
+    auto applyIni = [&](const IniConfig& config, ConfigLayer layer) {
+        for (const ConfigSchema::KeyInfo& info : ConfigSchema::kKeys) {
+            std::string_view value = config.GetValueView(info.section, info.name);
+            if (value.empty() || EqualsIgnoreCase(value, info.defaultValue)) continue;
+            if (_settings.Apply(info.id, value)) {
+                _sources[static_cast<size_t>(info.id)] = layer;
+            }
+        }
+    };
+    auto applyOverrides = [&](const ConfigOverrides& overrides, ConfigLayer layer) {
+        for (const ConfigOverrides::Value& value : overrides.values) {
+            if (_settings.Apply(value.key, value.value)) {
+                _sources[static_cast<size_t>(value.key)] = layer;
+            }
+        }
+    };
+
+    if (machine) {
+        applyIni(*machine, ConfigLayer::Machine);
+    }
+    applyIni(game, ConfigLayer::Game);
+    applyOverrides(environment, ConfigLayer::Environment);
+    applyOverrides(commandLine, ConfigLayer::CommandLine);
+}
+
+std::string LayeredConfig::MachineConfigPath() {
+    std::string path;
+    if (GetEnvironment("UC_ONLINE_MACHINE_CONFIG", path) && !path.empty()) return path;
+#ifdef _WIN32
+    std::string programData;
+    if (!GetEnvironment("ProgramData", programData) || programData.empty()) return std::string();
+    return PathUtils::ToUtf8(PathUtils::ToPath(programData) / "uc-online" / "config.ini");
+#else
+    return "/etc/uc-online/config.ini";
+#endif
+}
+
+std::unique_ptr<IniConfig> LayeredConfig::LoadMachineConfig() {
+    std::string path = MachineConfigPath();
+    if (path.empty()) return nullptr;
+
+    std::ifstream file(PathUtils::ToPath(path), std::ios::binary);
+    if (!file.is_open()) return nullptr;
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return std::make_unique<IniConfig>(path, std::move(contents));
+}
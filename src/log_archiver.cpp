@@ -0,0 +1,181 @@
+#include "log_archiver.hpp"
+#include "gzip.hpp"
+#include "path_utils.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+namespace {
+    // Length of the YYYYmmdd-HHMMSS-mmm part of a rotated log name
+    constexpr size_t kStampLength = 19;
+
+    bool IsStamp(const std::string& text) {
+        if (text.size() != kStampLength) return false;
+        for (size_t i = 0; i < text.size(); i++) {
+            bool dash = (i == 8 || i == 15);
+            if (dash ? text[i] != '-' : !std::isdigit(static_cast<unsigned char>(text[i]))) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+LogArchiver::LogArchiver(const std::string& logFilePath, size_t retainedFiles, bool compress)
+    : _retainedFiles(retainedFiles), _compress(compress) {
+    std::filesystem::path path = PathUtils::ToPath(logFilePath);
+    _directory = path.parent_path();
+    _stem = PathUtils::ToUtf8(path.stem());
+    _extension = PathUtils::ToUtf8(path.extension());
+
+    // An empty job means "sweep": compress anything a previous run rotated but never got to
+    _jobs.push_back(std::string());
+    _thread = std::thread(&LogArchiver::Run, this);
+}
+
+LogArchiver::~LogArchiver() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _wake.notify_one();
+    _thread.join();
+}
+
+std::string LogArchiver::NextRotatedPath() const {
+    auto now = std::chrono::system_clock::now();
+    auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
+
+    // Bump the milliseconds until the name is free, rotating twice in one millisecond is rare but possible
+    for (;;) {
+        std::time_t seconds = static_cast<std::time_t>(millis / 1000);
+        std::tm tm;
+#ifdef _WIN32
+        localtime_s(&tm, &seconds);
+#else
+        localtime_r(&seconds, &tm);
+#endif
+        char stamp[32];
+        size_t length = std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &tm);
+        std::snprintf(stamp + length, sizeof(stamp) - length, "-%03d", static_cast<int>(millis % 1000));
+
+        std::string candidate = PathUtils::ToUtf8(_directory / PathUtils::ToPath(_stem + "." + stamp + _extension));
+        std::error_code ec;
+        if (!std::filesystem::exists(PathUtils::ToPath(candidate), ec) && !std::filesystem::exists(PathUtils::ToPath(candidate + ".gz"), ec)) {
+            return candidate;
+        }
+        millis++;
+    }
+}
+
+void LogArchiver::Submit(const std::string& rotatedPath) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _jobs.push_back(rotatedPath);
+    }
+    _wake.notify_one();
+}
+
+void LogArchiver::Run() {
+    for (;;) {
+        std::string job;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wake.wait(lock, [this] { return _stop || !_jobs.empty(); });
+            if (_jobs.empty()) {
+                return;
+            }
+            job = std::move(_jobs.front());
+            _jobs.pop_front();
+        }
+
+        try {
+            if (job.empty()) {
+                CompressLeftovers();
+            } else if (_compress) {
+                Compress(PathUtils::ToPath(job));
+            }
+            Prune();
+        } catch (const std::exception& ex) {
+            std::cerr << "Log archiving error: " << ex.what() << std::endl;
+        }
+    }
+}
+
+void LogArchiver::Compress(const std::filesystem::path& rotatedPath) {
+    std::string target = PathUtils::ToUtf8(rotatedPath) + ".gz";
+    std::string temporary = target + ".tmp";
+
+    std::error_code ec;
+    // Already pruned while it was waiting in the queue
+    if (!std::filesystem::exists(rotatedPath, ec)) return;
+
+    if (!Gzip::CompressFile(PathUtils::ToUtf8(rotatedPath), temporary)) {
+        std::cerr << "Failed to compress rotated log: " << PathUtils::ToUtf8(rotatedPath) << std::endl;
+        std::filesystem::remove(PathUtils::ToPath(temporary), ec);
+        return;
+    }
+    std::filesystem::rename(PathUtils::ToPath(temporary), PathUtils::ToPath(target), ec);
+    if (ec) {
+        std::cerr << "Failed to compress rotated log: " << ec.message() << std::endl;
+        std::filesystem::remove(PathUtils::ToPath(temporary), ec);
+        return;
+    }
+    std::filesystem::remove(rotatedPath, ec);
+}
+
+void LogArchiver::CompressLeftovers() {
+    if (!_compress) return;
+
+    std::error_code ec;
+    std::vector<std::filesystem::path> leftovers;
+    for (const auto& entry : std::filesystem::directory_iterator(_directory.empty() ? "." : _directory, ec)) {
+        bool compressed = false;
+        if (IsRotatedName(PathUtils::ToUtf8(entry.path().filename()), compressed) && !compressed) {
+            leftovers.push_back(entry.path());
+        }
+    }
+    for (const auto& path : leftovers) {
+        Compress(path);
+    }
+}
+
+void LogArchiver::Prune() {
+    std::error_code ec;
+    std::vector<std::filesystem::path> rotated;
+    for (const auto& entry : std::filesystem::directory_iterator(_directory.empty() ? "." : _directory, ec)) {
+        bool compressed = false;
+        if (IsRotatedName(PathUtils::ToUtf8(entry.path().filename()), compressed)) {
+            rotated.push_back(entry.path());
+        }
+    }
+    if (rotated.size() <= _retainedFiles) return;
+
+    // Names sort oldest first, so everything before the last _retainedFiles goes
+    std::sort(rotated.begin(), rotated.end());
+    for (size_t i = 0; i < rotated.size() - _retainedFiles; i++) {
+        std::filesystem::remove(rotated[i], ec);
+    }
+}
+
+bool LogArchiver::IsRotatedName(const std::string& fileName, bool& compressed) const {
+    std::string prefix = _stem + ".";
+    if (fileName.size() < prefix.size() + kStampLength + _extension.size()) return false;
+    if (fileName.compare(0, prefix.size(), prefix) != 0) return false;
+    if (!IsStamp(fileName.substr(prefix.size(), kStampLength))) return false;
+
+    std::string rest = fileName.substr(prefix.size() + kStampLength);
+    if (rest == _extension) {
+        compressed = false;
+        return true;
+    }
+    if (rest == _extension + ".gz") {
+        compressed = true;
+        return true;
+    }
+    return false;
+}
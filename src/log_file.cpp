@@ -0,0 +1,90 @@
+#include "log_file.hpp"
+#include "path_utils.hpp"
+#include <cstring>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+LogFile::LogFile(size_t bufferSize) : _buffer(bufferSize < 256 ? 256 : bufferSize) {
+}
+
+LogFile::~LogFile() {
+    Close();
+}
+
+bool LogFile::Open(const std::string& path) {
+    Close();
+#ifdef _WIN32
+    _file = _wfopen(PathUtils::ToPath(path).c_str(), L"ab");
+#else
+    _file = std::fopen(path.c_str(), "ab");
+#endif
+    if (!_file) {
+        return false;
+    }
+    // Our own buffer is the only one, the CRT doesn't need to keep a second copy
+    std::setvbuf(_file, nullptr, _IONBF, 0);
+    return true;
+}
+
+bool LogFile::IsOpen() const {
+    return _file != nullptr;
+}
+
+void LogFile::Close() {
+    if (_file) {
+        Flush();
+        std::fclose(_file);
+        _file = nullptr;
+    }
+}
+
+bool LogFile::Append(const char* data, size_t size) {
+    if (!_file) return false;
+
+    if (_used + size > _buffer.size()) {
+        if (!Flush()) return false;
+        // Lines bigger than the whole buffer go straight to the file
+        if (size > _buffer.size()) {
+            return WriteThrough(data, size);
+        }
+    }
+    std::memcpy(_buffer.data() + _used, data, size);
+    _used += size;
+    return true;
+}
+
+bool LogFile::Append(const std::string& text) {
+    return Append(text.data(), text.size());
+}
+
+bool LogFile::Flush() {
+    if (!_file) return false;
+    if (_used == 0) return true;
+
+    bool ok = WriteThrough(_buffer.data(), _used);
+    _used = 0;
+    return ok;
+}
+
+bool LogFile::Truncate() {
+    if (!_file) return false;
+
+    _used = 0;
+#ifdef _WIN32
+    return _chsize_s(_fileno(_file), 0) == 0;
+#else
+    return ftruncate(fileno(_file), 0) == 0;
+#endif
+}
+
+size_t LogFile::PendingBytes() const {
+    return _used;
+}
+
+bool LogFile::WriteThrough(const char* data, size_t size) {
+    return std::fwrite(data, 1, size, _file) == size;
+}
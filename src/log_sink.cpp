@@ -0,0 +1,122 @@
+#include "log_sink.hpp"
+#include "binary_log_format.hpp"
+#include "log_format.hpp"
+#include "path_utils.hpp"
+#include <filesystem>
+#include <iostream>
+
+namespace {
+    void AppendJsonString(std::string& out, std::string_view text) {
+        static const char hex[] = "0123456789abcdef";
+        out.push_back('"');
+        for (char c : text) {
+            switch (c) {
+            case '"': out.append("\\\""); break;
+            case '\\': out.append("\\\\"); break;
+            case '\n': out.append("\\n"); break;
+            case '\r': out.append("\\r"); break;
+            case '\t': out.append("\\t"); break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out.append("\\u00");
+                    out.push_back(hex[(c >> 4) & 0xF]);
+                    out.push_back(hex[c & 0xF]);
+                } else {
+                    out.push_back(c);
+                }
+                break;
+            }
+        }
+        out.push_back('"');
+    }
+}
+
+LogSink::LogSink(const std::string& path, size_t bufferSize) : _path(path), _file(bufferSize) {
+}
+
+void LogSink::Flush() {
+    _file.Flush();
+}
+
+void LogSink::Close() {
+    _file.Close();
+    _closed = true;
+}
+
+bool LogSink::Append(const std::string& data) {
+    if (!_file.IsOpen()) {
+        if (!_file.Open(_path)) {
+            // Tried again on every write, but only worth saying once
+            if (!_reportedError) {
+                std::cerr << "Logging error: Could not open log file: " << _path << std::endl;
+                _reportedError = true;
+            }
+            return false;
+        }
+        std::error_code ec;
+        uintmax_t existing = std::filesystem::file_size(PathUtils::ToPath(_path), ec);
+        if (ec) existing = 0;
+        _size = _closed ? 0 : existing;
+        _started = std::chrono::system_clock::now();
+        OnOpen(existing == 0);
+    }
+    if (!_file.Append(data)) {
+        return false;
+    }
+    _size += data.size();
+    return true;
+}
+
+JsonLinesLogSink::JsonLinesLogSink(const std::string& path, size_t bufferSize) : LogSink(path, bufferSize) {
+}
+
+void JsonLinesLogSink::Write(const LogRecord& record, std::string_view timestamp) {
+    _line.clear();
+    _line.append("{\"ts\":");
+    AppendJsonString(_line, timestamp);
+    _line.append(",\"mono_ns\":");
+    LogFormat::Append(_line, record.monotonicNs);
+    _line.append(",\"level\":\"");
+    _line.append(LogLevelName(record.level));
+    _line.append("\",\"thread\":");
+    LogFormat::Append(_line, record.threadId);
+    _line.append(",\"source\":");
+    AppendJsonString(_line, record.source);
+    _line.append(",\"msg\":");
+    AppendJsonString(_line, record.message);
+    _line.append("}\n");
+    Append(_line);
+}
+
+BinaryLogSink::BinaryLogSink(const std::string& path, size_t bufferSize, std::chrono::system_clock::time_point sessionStart)
+    : LogSink(path, bufferSize), _sessionStart(sessionStart) {
+}
+
+void BinaryLogSink::OnOpen(bool isNew) {
+    // Not _entry, this runs in the middle of appending it
+    std::string header;
+    if (isNew) {
+        header.append(BinaryLog::kMagic, sizeof(BinaryLog::kMagic));
+    }
+    header.push_back(static_cast<char>(BinaryLog::kSessionEntry));
+    BinaryLog::PutU16(header, BinaryLog::kVersion);
+    BinaryLog::PutU64(header, static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(_sessionStart.time_since_epoch()).count()));
+    Append(header);
+}
+
+void BinaryLogSink::Write(const LogRecord& record, std::string_view) {
+    size_t sourceLength = std::char_traits<char>::length(record.source);
+    if (sourceLength > 0xFFFF) sourceLength = 0xFFFF;
+
+    _entry.clear();
+    _entry.push_back(static_cast<char>(BinaryLog::kRecordEntry));
+    _entry.push_back(static_cast<char>(record.level));
+    BinaryLog::PutU16(_entry, static_cast<uint16_t>(sourceLength));
+    BinaryLog::PutU32(_entry, static_cast<uint32_t>(record.message.size()));
+    BinaryLog::PutU64(_entry, record.monotonicNs);
+    BinaryLog::PutU64(_entry, record.threadId);
+    _entry.append(record.source, sourceLength);
+    _entry.append(record.message);
+    Append(_entry);
+}
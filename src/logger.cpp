@@ -1,97 +1,486 @@
 #include "logger.hpp"
+#include "ini_config.hpp"
+#include <cstring>
+#include <ctime>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 
-Logger::Logger(const std::string& logFilePath, bool enableLogging)
-    : _logFilePath(PathUtils::ResolveRelativeToExecutable(logFilePath)), _loggingEnabled(enableLogging) {
+namespace {
+    // Upper bound on lines the writer thread concatenates into a single write
+    constexpr size_t kMaxWriterBatch = 256;
+
+    uint64_t CurrentThreadId() {
+        thread_local uint64_t id = std::hash<std::thread::id>()(std::this_thread::get_id());
+        return id;
+    }
+
+    struct LevelName {
+        const char* text;
+        size_t length;
+    };
+
+    const LevelName kLevelNames[] = {
+        { " [DEBUG] ", 9 },
+        { " [INFO] ", 8 },
+        { " [WARNING] ", 11 },
+        { " [ERROR] ", 9 },
+        { " [EXCEPTION] ", 13 }
+    };
+
+    // When an existing log was started, taken from the timestamp on its first line.
+    // Falls back to now if the file doesn't start with one of our lines.
+    std::chrono::system_clock::time_point ReadLogStartTime(const std::string& path) {
+        auto now = std::chrono::system_clock::now();
+        std::ifstream file(PathUtils::ToPath(path), std::ios::binary);
+        char head[64] = {};
+        file.read(head, sizeof(head) - 1);
+        std::string line(head, static_cast<size_t>(file.gcount()));
+
+        const char* pattern = "dddd-dd-dd dd:dd:dd";
+        size_t patternLength = std::strlen(pattern);
+        for (size_t start = 0; start + patternLength <= line.size(); start++) {
+            bool matches = true;
+            for (size_t i = 0; i < patternLength && matches; i++) {
+                char c = line[start + i];
+                matches = pattern[i] == 'd' ? (c >= '0' && c <= '9') : c == pattern[i];
+            }
+            if (!matches) continue;
+
+            auto number = [&](size_t offset, size_t digits) {
+                int value = 0;
+                for (size_t i = 0; i < digits; i++) {
+                    value = value * 10 + (line[start + offset + i] - '0');
+                }
+                return value;
+            };
+            std::tm tm = {};
+            tm.tm_year = number(0, 4) - 1900;
+            tm.tm_mon = number(5, 2) - 1;
+            tm.tm_mday = number(8, 2);
+            tm.tm_hour = number(11, 2);
+            tm.tm_min = number(14, 2);
+            tm.tm_sec = number(17, 2);
+            tm.tm_isdst = -1;
+            std::time_t started = std::mktime(&tm);
+            return started == -1 ? now : std::chrono::system_clock::from_time_t(started);
+        }
+        return now;
+    }
+}
+
+// The choice lists in ConfigSchema are in enum order, so a parsed choice casts straight to the enum
+static_assert(ConfigSchema::FindChoice(ConfigSchema::Info(ConfigKey::LogLevel).choices, "error") == static_cast<int>(LogLevel::Error));
+static_assert(ConfigSchema::FindChoice(ConfigSchema::Info(ConfigKey::FlushPolicy).choices, "error") == static_cast<int>(LogFlushPolicy::OnError));
+static_assert(ConfigSchema::FindChoice(ConfigSchema::Info(ConfigKey::TimestampPrecision).choices, "microseconds") == static_cast<int>(TimestampPrecision::Microseconds));
+static_assert(ConfigSchema::FindChoice(ConfigSchema::Info(ConfigKey::TimestampClock).choices, "monotonic") == static_cast<int>(TimestampClock::Monotonic));
+static_assert(ConfigSchema::FindChoice(ConfigSchema::Info(ConfigKey::AsyncOverflowPolicy).choices, "drop-oldest") == static_cast<int>(LogOverflowPolicy::DropOldest));
+
+LoggerOptions LoggerOptions::FromConfig(const IniConfig& config) {
+    return FromSettings(config.GetSettings());
+}
+
+LoggerOptions LoggerOptions::FromSettings(const LauncherSettings& settings) {
+    LoggerOptions options;
+    options.minLevel = static_cast<LogLevel>(settings.Get<ConfigKey::LogLevel>());
+
+    options.flushPolicy = static_cast<LogFlushPolicy>(settings.Get<ConfigKey::FlushPolicy>());
+    options.flushBytes = settings.Get<ConfigKey::FlushBytes>();
+    options.flushIntervalMs = settings.Get<ConfigKey::FlushIntervalMs>();
+    options.writeBufferSize = settings.Get<ConfigKey::WriteBufferSize>();
+
+    options.timestampPrecision = static_cast<TimestampPrecision>(settings.Get<ConfigKey::TimestampPrecision>());
+    options.timestampClock = static_cast<TimestampClock>(settings.Get<ConfigKey::TimestampClock>());
+
+    options.maxFileSize = static_cast<uint64_t>(settings.Get<ConfigKey::MaxLogSizeKB>()) * 1024;
+    options.maxFileAgeHours = settings.Get<ConfigKey::MaxLogAgeHours>();
+    options.retainedLogs = settings.Get<ConfigKey::RetainedLogs>();
+    options.compressRotatedLogs = settings.Get<ConfigKey::CompressRotatedLogs>();
+
+    const std::string& sinks = settings.Get<ConfigKey::Sinks>();
+    options.textSink = sinks.find("text") != std::string::npos;
+    options.jsonSink = sinks.find("json") != std::string::npos;
+    options.binarySink = sinks.find("binary") != std::string::npos;
+    options.jsonLogFile = PathUtils::ToUtf8(settings.Get<ConfigKey::JsonLogFile>());
+    options.binaryLogFile = PathUtils::ToUtf8(settings.Get<ConfigKey::BinaryLogFile>());
+
+    options.asyncLogging = settings.Get<ConfigKey::AsyncLogging>();
+    options.asyncQueueSize = settings.Get<ConfigKey::AsyncQueueSize>();
+    options.overflowPolicy = static_cast<LogOverflowPolicy>(settings.Get<ConfigKey::AsyncOverflowPolicy>());
+    return options;
+}
+
+Logger::Logger(const std::string& logFilePath, bool enableLogging, const LoggerOptions& options)
+    : _logFilePath(PathUtils::ResolveRelativeToExecutable(logFilePath)), _loggingEnabled(enableLogging),
+      _threshold(static_cast<int>(LogLevel::Off)), _file(options.writeBufferSize), _timestamp(options.timestampPrecision, options.timestampClock),
+      _started(std::chrono::steady_clock::now()), _lastFlush(std::chrono::steady_clock::now()), _options(options) {
+    UpdateThreshold();
+    if (_options.maxFileSize > 0 || _options.maxFileAgeHours > 0) {
+        _archiver = std::make_unique<LogArchiver>(_logFilePath, _options.retainedLogs, _options.compressRotatedLogs);
+    }
+    if (_options.asyncLogging) {
+        StartWriter();
+    }
     if (_loggingEnabled) {
         Log("Logger initialized");
     }
 }
 
+Logger::~Logger() {
+    if (_writerThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(_writerMutex);
+            _stopWriter = true;
+        }
+        _writerWake.notify_one();
+        // The writer drains everything still queued before it exits
+        _writerThread.join();
+    }
+
+    std::lock_guard<std::mutex> lock(_lock);
+    _file.Close();
+    _sinks.clear();
+    // Waits for any rotated log still being compressed
+    _archiver.reset();
+}
+
 void Logger::SetLoggingEnabled(bool enabled) {
     _loggingEnabled = enabled;
-    Log("Logging " + std::string(enabled ? "enabled" : "disabled"));
+    UpdateThreshold();
+    Info("Logging ", enabled ? "enabled" : "disabled");
 }
 
 bool Logger::IsLoggingEnabledA() const {
     return _loggingEnabled;
 }
 
-void Logger::Log(const std::string& message) {
-    if (!_loggingEnabled) return;
+void Logger::SetLogFilePath(const std::string& logFilePath) {
+    std::string resolved = PathUtils::ResolveRelativeToExecutable(logFilePath);
+    // Anything still queued belongs to the old file
+    Flush();
 
-    std::string logMessage = GetCurrentTimeString() + " [INFO] " + message + "\n";
+    std::lock_guard<std::mutex> lock(_lock);
+    if (resolved == _logFilePath) return;
+    _file.Close();
+    _logFilePath = resolved;
+    if (_archiver) {
+        _archiver = std::make_unique<LogArchiver>(_logFilePath, _options.retainedLogs, _options.compressRotatedLogs);
+    }
+}
 
+std::string Logger::GetLogFilePath() {
     std::lock_guard<std::mutex> lock(_lock);
-    std::ofstream file(_logFilePath, std::ios::app);
-    if (file.is_open()) {
-        file << logMessage;
-    } else {
-        std::cerr << "Logging error: Could not open log file" << std::endl;
+    return _logFilePath;
+}
+
+void Logger::UpdateThreshold() {
+    int level = static_cast<int>(_options.minLevel);
+    if (level < UC_ONLINE_MIN_LOG_LEVEL) {
+        level = UC_ONLINE_MIN_LOG_LEVEL;
     }
+    _threshold = _loggingEnabled ? level : static_cast<int>(LogLevel::Off);
+}
+
+void Logger::Log(const std::string& message) {
+    if (!ShouldLog(LogLevel::Info)) return;
+    Write(LogLevel::Info, message);
 }
 
 void Logger::LogWarning(const std::string& message) {
+    if (!ShouldLog(LogLevel::Warning)) return;
+    Write(LogLevel::Warning, message);
+}
+
+void Logger::LogError(const std::string& message) {
+    if (!ShouldLog(LogLevel::Error)) return;
+    Write(LogLevel::Error, message);
+}
+
+void Logger::LogException(const std::exception& ex, const std::string& context) {
+    if (!ShouldLog(LogLevel::Exception)) return;
+    Write(LogLevel::Exception, context + ": " + ex.what());
+}
+
+void Logger::ClearLog() {
     if (!_loggingEnabled) return;
 
-    std::string logMessage = GetCurrentTimeString() + " [WARNING] " + message + "\n";
+    // Make sure nothing queued before the clear ends up after the header
+    Flush();
 
     std::lock_guard<std::mutex> lock(_lock);
-    std::ofstream file(_logFilePath, std::ios::app);
-    if (file.is_open()) {
-        file << logMessage;
-    } else {
-        std::cerr << "Logging error: Could not open log file" << std::endl;
+    if (!EnsureFileOpen() || !_file.Truncate()) {
+        std::cerr << "Error clearing log: Could not open log file" << std::endl;
+        return;
     }
+    char timestamp[TimestampFormatter::kMaxLength];
+    size_t length = _timestamp.Format(timestamp);
+    _lineBuffer.assign("uc-online Log - ");
+    _lineBuffer.append(timestamp, length);
+    _lineBuffer.push_back('\n');
+    _file.Append(_lineBuffer);
+    _file.Flush();
+    _lastFlush = std::chrono::steady_clock::now();
+    _fileSize = _lineBuffer.size();
+    _fileStarted = std::chrono::system_clock::now();
 }
 
-void Logger::LogError(const std::string& message) {
-    if (!_loggingEnabled) return;
+void Logger::Flush() {
+    if (!_queue) {
+        std::lock_guard<std::mutex> lock(_lock);
+        FlushAll();
+        return;
+    }
 
-    std::string logMessage = GetCurrentTimeString() + " [ERROR] " + message + "\n";
+    size_t target = _queue->EnqueuePosition();
+    std::unique_lock<std::mutex> lock(_writerMutex);
+    _wakeRequested = true;
+    _writerWake.notify_one();
+    _writerDrained.wait(lock, [&] { return _writtenPosition.load() >= target; });
+}
 
+void Logger::FlushIfDue() {
+    if (_options.flushPolicy != LogFlushPolicy::Interval) return;
     std::lock_guard<std::mutex> lock(_lock);
-    std::ofstream file(_logFilePath, std::ios::app);
-    if (file.is_open()) {
-        file << logMessage;
-    } else {
-        std::cerr << "Logging error: Could not open log file" << std::endl;
+    if (std::chrono::steady_clock::now() - _lastFlush >= std::chrono::milliseconds(_options.flushIntervalMs)) {
+        FlushAll();
     }
 }
 
-void Logger::LogException(const std::exception& ex, const std::string& context) {
-    if (!_loggingEnabled) return;
+std::chrono::milliseconds Logger::GetFlushInterval() const {
+    if (_options.flushPolicy != LogFlushPolicy::Interval) return std::chrono::milliseconds(0);
+    return std::chrono::milliseconds(_options.flushIntervalMs);
+}
+
+uint64_t Logger::GetDroppedCount() const {
+    return _droppedCount.load();
+}
 
-    std::string logMessage = GetCurrentTimeString() + " [EXCEPTION] " + context + ": " + ex.what() + "\n";
+void Logger::Write(LogLevel level, const std::string& message) {
+    auto time = _timestamp.Now();
+    uint64_t monotonicNs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _started).count());
+
+    if (_queue) {
+        Enqueue(LogRecord{ time, monotonicNs, CurrentThreadId(), level, LogSourceScope::Current(), message });
+        return;
+    }
 
     std::lock_guard<std::mutex> lock(_lock);
-    std::ofstream file(_logFilePath, std::ios::app);
-    if (file.is_open()) {
-        file << logMessage;
-    } else {
-        std::cerr << "Logging error: Could not open log file" << std::endl;
+    _syncRecord.time = time;
+    _syncRecord.monotonicNs = monotonicNs;
+    _syncRecord.threadId = CurrentThreadId();
+    _syncRecord.level = level;
+    _syncRecord.source = LogSourceScope::Current();
+    _syncRecord.message.assign(message);
+
+    _lineBuffer.clear();
+    FormatRecord(_syncRecord);
+    WriteFormatted(ShouldFlush(level));
+}
+
+void Logger::FormatRecord(const LogRecord& record) {
+    if (!_sinksOpened) {
+        _sinksOpened = true;
+        if (_options.jsonSink) {
+            _sinks.push_back(SinkOutput{ std::make_unique<JsonLinesLogSink>(
+                PathUtils::ResolveRelativeToExecutable(_options.jsonLogFile), _options.writeBufferSize), nullptr });
+        }
+        if (_options.binarySink) {
+            auto sessionStart = std::chrono::system_clock::now() -
+                std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::steady_clock::now() - _started);
+            _sinks.push_back(SinkOutput{ std::make_unique<BinaryLogSink>(
+                PathUtils::ResolveRelativeToExecutable(_options.binaryLogFile), _options.writeBufferSize, sessionStart), nullptr });
+        }
+        // Same limits and retention as the text log, each file rotated on its own
+        if (_archiver) {
+            for (SinkOutput& output : _sinks) {
+                output.archiver = std::make_unique<LogArchiver>(output.sink->GetPath(), _options.retainedLogs, _options.compressRotatedLogs);
+            }
+        }
+    }
+
+    // The timestamp is formatted once and shared by every output
+    char timestamp[TimestampFormatter::kMaxLength];
+    size_t length = _timestamp.Format(timestamp, record.time);
+
+    if (_options.textSink) {
+        const LevelName& name = kLevelNames[static_cast<int>(record.level)];
+        _lineBuffer.append(timestamp, length);
+        _lineBuffer.append(name.text, name.length);
+        _lineBuffer.append(record.message);
+        _lineBuffer.push_back('\n');
+    }
+    for (SinkOutput& output : _sinks) {
+        output.sink->Write(record, std::string_view(timestamp, length));
     }
 }
 
-void Logger::ClearLog() {
-    if (!_loggingEnabled) return;
+void Logger::WriteFormatted(bool flush) {
+    if (_options.textSink && !_lineBuffer.empty()) {
+        if (!EnsureFileOpen() || !_file.Append(_lineBuffer)) {
+            std::cerr << "Logging error: Could not open log file" << std::endl;
+            return;
+        }
+        _fileSize += _lineBuffer.size();
+    }
+    if (flush) {
+        FlushAll();
+    }
+    RotateIfNeeded();
+}
 
-    std::lock_guard<std::mutex> lock(_lock);
-    std::ofstream file(_logFilePath, std::ios::trunc);
-    if (file.is_open()) {
-        file << "uc-online Log - " << GetCurrentTimeString() << "\n";
+void Logger::FlushAll() {
+    _file.Flush();
+    for (SinkOutput& output : _sinks) {
+        output.sink->Flush();
+    }
+    _lastFlush = std::chrono::steady_clock::now();
+}
+
+bool Logger::EnsureFileOpen() {
+    return _file.IsOpen() || OpenFile();
+}
+
+bool Logger::OpenFile() {
+    if (!_file.Open(_logFilePath)) {
+        return false;
+    }
+    if (_archiver) {
+        std::error_code ec;
+        uintmax_t size = std::filesystem::file_size(PathUtils::ToPath(_logFilePath), ec);
+        _fileSize = ec ? 0 : size;
+        _fileStarted = _fileSize > 0 ? ReadLogStartTime(_logFilePath) : std::chrono::system_clock::now();
+    }
+    return true;
+}
+
+void Logger::RotateIfNeeded() {
+    if (!_archiver) return;
+
+    if (_options.textSink && _file.IsOpen() && IsRotationDue(_fileSize, _fileStarted)) {
+        _file.Close();
+        RotateFile(_logFilePath, *_archiver);
+        // Also when the rename failed: try again once another full file's worth is written
+        _fileSize = 0;
+        _fileStarted = std::chrono::system_clock::now();
+    }
+    for (SinkOutput& output : _sinks) {
+        if (output.archiver && output.sink->GetSize() > 0 && IsRotationDue(output.sink->GetSize(), output.sink->GetStarted())) {
+            output.sink->Close();
+            RotateFile(output.sink->GetPath(), *output.archiver);
+        }
+    }
+}
+
+bool Logger::IsRotationDue(uint64_t size, std::chrono::system_clock::time_point started) const {
+    bool tooBig = _options.maxFileSize > 0 && size >= _options.maxFileSize;
+    bool tooOld = _options.maxFileAgeHours > 0 &&
+        std::chrono::system_clock::now() - started >= std::chrono::hours(_options.maxFileAgeHours);
+    return tooBig || tooOld;
+}
+
+void Logger::RotateFile(const std::string& path, LogArchiver& archiver) {
+    std::string rotatedPath = archiver.NextRotatedPath();
+    std::error_code ec;
+    std::filesystem::rename(PathUtils::ToPath(path), PathUtils::ToPath(rotatedPath), ec);
+    if (ec) {
+        // Probably held open by another launcher
+        std::cerr << "Log rotation failed: " << ec.message() << std::endl;
     } else {
-        std::cerr << "Error clearing log: Could not open log file" << std::endl;
+        archiver.Submit(rotatedPath);
+    }
+}
+
+bool Logger::ShouldFlush(LogLevel level) const {
+    switch (_options.flushPolicy) {
+    case LogFlushPolicy::Bytes:
+        return _file.PendingBytes() >= _options.flushBytes;
+    case LogFlushPolicy::Interval:
+        return std::chrono::steady_clock::now() - _lastFlush >= std::chrono::milliseconds(_options.flushIntervalMs);
+    case LogFlushPolicy::OnError:
+        return level == LogLevel::Error || level == LogLevel::Exception;
+    case LogFlushPolicy::EveryLine:
+    default:
+        return true;
     }
 }
 
-std::string Logger::GetCurrentTimeString() const {
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
-    std::tm tm;
-    localtime_s(&tm, &time_t);
-    std::stringstream ss;
-    ss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-    return ss.str();
-}
\ No newline at end of file
+void Logger::StartWriter() {
+    _queue = std::make_unique<LogRingBuffer<LogRecord>>(_options.asyncQueueSize);
+    _writerThread = std::thread(&Logger::WriterLoop, this);
+}
+
+void Logger::Enqueue(LogRecord&& record) {
+    if (_queue->TryPush(record)) return;
+
+    switch (_options.overflowPolicy) {
+    case LogOverflowPolicy::DropNewest:
+        _droppedCount++;
+        break;
+    case LogOverflowPolicy::DropOldest: {
+        LogRecord discarded;
+        while (!_queue->TryPush(record)) {
+            if (_queue->TryPop(discarded)) {
+                _droppedCount++;
+            }
+        }
+        break;
+    }
+    case LogOverflowPolicy::Block:
+        while (!_queue->TryPush(record)) {
+            {
+                std::lock_guard<std::mutex> lock(_writerMutex);
+                _wakeRequested = true;
+            }
+            _writerWake.notify_one();
+            std::this_thread::yield();
+        }
+        break;
+    }
+}
+
+void Logger::WriterLoop() {
+    for (;;) {
+        bool stopping = _stopWriter.load();
+        bool wroteAnything = DrainQueue();
+        if (stopping && !wroteAnything && _queue->DequeuePosition() == _queue->EnqueuePosition()) {
+            break;
+        }
+        if (!wroteAnything) {
+            {
+                std::unique_lock<std::mutex> lock(_writerMutex);
+                _writerWake.wait_for(lock, std::chrono::milliseconds(50), [this] { return _wakeRequested || _stopWriter; });
+                _wakeRequested = false;
+            }
+            // Nothing new came in, whatever is still buffered goes out once the interval is up
+            FlushIfDue();
+        }
+    }
+}
+
+bool Logger::DrainQueue() {
+    LogRecord record;
+    _writerBatch.clear();
+    while (_writerBatch.size() < kMaxWriterBatch && _queue->TryPop(record)) {
+        _writerBatch.push_back(std::move(record));
+    }
+    // Everything below this position was either written here or dropped by a producer
+    size_t drainedTo = _queue->DequeuePosition();
+
+    if (!_writerBatch.empty()) {
+        // The writer already runs off the hot path, so each batch is flushed as a whole
+        std::lock_guard<std::mutex> lock(_lock);
+        _lineBuffer.clear();
+        for (const LogRecord& queued : _writerBatch) {
+            FormatRecord(queued);
+        }
+        WriteFormatted(true);
+    }
+
+    if (drainedTo > _writtenPosition.load()) {
+        std::lock_guard<std::mutex> lock(_writerMutex);
+        _writtenPosition = drainedTo;
+        _writerDrained.notify_all();
+    }
+    return !_writerBatch.empty();
+}
@@ -1,13 +1,29 @@
 #include "uc_online.hpp"
+#include "steam_api_backend.hpp"
 #include <iostream>
-#include <thread>
 #include <chrono>
 
-int main() {
-    std::cout << "uc-online Launcher 32-bit" << std::endl;
+// CMake defines IS_64BIT for the 64-bit target, the same main() builds both launchers
+#ifdef IS_64BIT
+using LauncherTraits = Launcher64Traits;
+#else
+using LauncherTraits = Launcher32Traits;
+#endif
+
+// How long the window stays open when no game got started, so the messages can be read
+static const int kNoGameSeconds = 5;
+
+int main(int argc, char* argv[]) {
+    std::cout << "uc-online Launcher " << LauncherTraits::kArchitecture << std::endl;
     std::cout << "=========================" << std::endl << std::endl;
 
-    UCOnline uc_online;
+    // Anything like --appid=730 on the command line wins over config.ini for this run
+    ConfigOverrides commandLine = ConfigOverrides::FromCommandLine(argc, argv);
+    for (const std::string& argument : commandLine.unknown) {
+        std::cout << "Ignoring unknown argument: " << argument << std::endl;
+    }
+
+    UCOnlineLauncher<LauncherTraits> uc_online(std::make_shared<SteamApiBackend>(), "config.ini", commandLine);
 
     try {
         std::cout << "Current configuration:" << std::endl;
@@ -16,42 +32,59 @@ int main() {
         std::cout << "  Game Arguments: " << (uc_online.GetGameArguments().empty() ? "(none)" : uc_online.GetGameArguments()) << std::endl;
         std::cout << std::endl;
 
-        uc_online.SetCustomAppID(480);
-        std::cout << "Using appid: " << uc_online.GetCurrentAppID() << " (Spacewar)" << std::endl;
+        std::cout << "Using appid: " << uc_online.GetCurrentAppID() << " (from "
+                  << ConfigLayerName(uc_online.GetResolvedConfig().GetSource(ConfigKey::AppID)) << ")" << std::endl;
 
-        uc_online.GetLogger()->Log("Now starting uc-online initialization");
-        uc_online.GetLogger()->Log("Appid set to: " + std::to_string(uc_online.GetCurrentAppID()));
+        uc_online.GetLogger()->Info("Now starting uc-online initialization");
+        uc_online.GetLogger()->Info("Appid set to: ", uc_online.GetCurrentAppID());
 
-        if (!uc_online.InitializeUCOnline()) {
-            uc_online.GetLogger()->LogError("uc-online initialization failed");
-            std::cout << "Failed to initialize Steam" << std::endl;
-            return 1;
-        }
+        // PipelinedLaunch starts the game while Steam is still coming up, needs a game to start
+        const LauncherSettings& settings = uc_online.GetResolvedConfig().GetSettings();
+        bool pipelined = settings.Get<ConfigKey::PipelinedLaunch>() && !uc_online.GetGameExecutable().empty();
+        bool launched = false;
+        if (pipelined) {
+            std::cout << "Starting Steam and the game together..." << std::endl;
+            launched = uc_online.LaunchGamePipelined();
+            if (!launched && !uc_online.IsSteamInitialized()) {
+                uc_online.GetLogger()->Error("uc-online initialization failed");
+                std::cout << "Failed to initialize Steam" << std::endl;
+                return 1;
+            }
+        } else {
+            if (!uc_online.InitializeUCOnline()) {
+                uc_online.GetLogger()->Error("uc-online initialization failed");
+                std::cout << "Failed to initialize Steam" << std::endl;
+                return 1;
+            }
 
-        std::cout << "Steam initialized successfully!" << std::endl;
+            std::cout << "Steam initialized successfully!" << std::endl;
 
-        if (!uc_online.GetGameExecutable().empty()) {
-            std::cout << "Attempting to launch game using set game executable in config..." << std::endl;
-            if (uc_online.LaunchGame()) {
-                std::cout << "Game launched! Press any key to close this window." << std::endl;
-                std::cin.get();
-                return 0;
+            if (!uc_online.GetGameExecutable().empty()) {
+                std::cout << "Attempting to launch game using set game executable in config..." << std::endl;
+                launched = uc_online.LaunchGame();
+            } else {
+                std::cout << "No game executable configured in config.ini file. You'll need to do that to get anywhere here." << std::endl;
+                std::cout << "You need to set a game's executable in the config.ini for this to work. There's no default exe." << std::endl;
             }
-        } else {
-            std::cout << "No game executable configured in config.ini file. You'll need to do that to get anywhere here." << std::endl;
-            std::cout << "You need to set a game's executable in the config.ini for this to work. There's no default exe." << std::endl;
         }
 
-        std::cout << "Game should now launch and work fine through Steam. You can close this window now or after the game's window opens, or even after you close the game." << std::endl;
+        uc_online.StartCallbackPump();
 
-        for (int i = 0; i < 5; i++) {
-            if (uc_online.IsSteamInitialized()) {
-                uc_online.RunSteamCallbacks();
-            }
-            std::this_thread::sleep_for(std::chrono::seconds(1));
-            std::cout << "Trying to run the game... This usually means it won't run even after successfully initializing Steam using a spoofed appid. Double check your config, especially the gameexecutable line." << std::endl; 
-            std::cout << "(" << (i + 1) << "/5 seconds until this window automatically closes unless game launch succeeds.)" << std::endl;
+        // Stays up for as long as the game runs, or a few seconds if there is no game to wait for
+        std::chrono::milliseconds timeout(static_cast<int64_t>(settings.Get<ConfigKey::ExitTimeoutSeconds>()) * 1000);
+        if (launched) {
+            std::cout << "Game launched! This window closes by itself when the game does (or press Ctrl+C to close it now)." << std::endl;
+        } else {
+            std::cout << "Trying to run the game... This usually means it won't run even after successfully initializing Steam using a spoofed appid. Double check your config, especially the gameexecutable line." << std::endl;
+            std::cout << "(This window closes automatically in " << kNoGameSeconds << " seconds.)" << std::endl;
+            timeout = std::chrono::seconds(kNoGameSeconds);
+        }
+
+        ExitReason reason = uc_online.WaitForExit(timeout);
+        if (reason == ExitReason::GameExited) {
+            std::cout << "Game closed." << std::endl;
         }
+        uc_online.StopCallbackPump();
 
         std::cout << std::endl << "This window is now safe to close." << std::endl;
     } catch (const std::exception& ex) {
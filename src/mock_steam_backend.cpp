@@ -0,0 +1,229 @@
+#include "mock_steam_backend.hpp"
+#include <cstring>
+#include <iterator>
+#include <thread>
+
+MockSteamBackend::MockSteamBackend() {
+}
+
+MockSteamBackend::MockSteamBackend(Script script) : _script(std::move(script)) {
+}
+
+void MockSteamBackend::QueueCallback(int id, std::vector<uint8_t> payload, uint32_t afterFrames) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    uint64_t frame = _frame + afterFrames;
+    auto position = _pending.end();
+    while (position != _pending.begin() && std::prev(position)->frame > frame) {
+        --position;
+    }
+    _pending.insert(position, Pending{ frame, MockSteamCallback{ id, std::move(payload) } });
+}
+
+void MockSteamBackend::QueueCallResult(uint64_t call, int resultId, std::vector<uint8_t> result, uint32_t afterFrames, bool failed) {
+    SteamApiCallCompleted completed = { call, resultId, static_cast<uint32_t>(result.size()) };
+    std::vector<uint8_t> payload(sizeof(completed));
+    std::memcpy(payload.data(), &completed, sizeof(completed));
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _callResults[call] = CallResult{ resultId, std::move(result), failed };
+    }
+    QueueCallback(SteamApiCallCompleted::kCallbackId, std::move(payload), afterFrames);
+}
+
+void MockSteamBackend::SetCallbackHandler(std::function<void(const MockSteamCallback&)> handler) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _handler = std::move(handler);
+}
+
+void MockSteamBackend::SetScript(const Script& script) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _script = script;
+}
+
+MockSteamBackend::Counters MockSteamBackend::GetCounters() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _counters;
+}
+
+bool MockSteamBackend::IsInitialized() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _initialized;
+}
+
+size_t MockSteamBackend::PendingCallbacks() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _pending.size();
+}
+
+std::string MockSteamBackend::GetLoadedPath() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _loadedPath;
+}
+
+bool MockSteamBackend::Load(const std::string& libraryPath, std::string& error) {
+    // Nothing to load, only the outcome is scripted
+    std::lock_guard<std::mutex> lock(_mutex);
+    _counters.loadCalls++;
+    _loadedPath = libraryPath;
+    if (_script.loadFails) {
+        error = _script.loadError;
+        return false;
+    }
+    return true;
+}
+
+bool MockSteamBackend::RestartAppIfNecessary(uint32_t) {
+    std::chrono::microseconds latency;
+    bool restart;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _counters.restartCalls++;
+        latency = _script.restartLatency;
+        restart = _script.restartRequired;
+    }
+    Delay(latency);
+    return restart;
+}
+
+SteamInitResult MockSteamBackend::Init(std::string& error) {
+    std::chrono::microseconds latency;
+    SteamInitResult result;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _counters.initCalls++;
+        latency = _script.initLatency;
+        result = _script.initResult;
+        if (result != SteamInitResult::OK) {
+            error = _script.initError;
+        }
+    }
+    Delay(latency);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _initialized = result == SteamInitResult::OK;
+    return result;
+}
+
+void MockSteamBackend::Shutdown() {
+    std::chrono::microseconds latency;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _counters.shutdownCalls++;
+        _initialized = false;
+        latency = _script.shutdownLatency;
+    }
+    Delay(latency);
+}
+
+uint32_t MockSteamBackend::RunCallbacks() {
+    // Like the real one, only ever called from one thread at a time, so _due can be reused
+    std::chrono::microseconds latency;
+    std::function<void(const MockSteamCallback&)> handler;
+    _due.clear();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _counters.runCallbacksCalls++;
+        latency = _script.runCallbacksLatency;
+        if (_initialized && !_manualDispatch) {
+            while (!_pending.empty() && _pending.front().frame <= _frame) {
+                _due.push_back(std::move(_pending.front().callback));
+                _pending.pop_front();
+            }
+            _counters.callbacksDelivered += _due.size();
+            _frame++;
+            handler = _handler;
+        }
+    }
+    Delay(latency);
+
+    if (handler) {
+        for (const MockSteamCallback& callback : _due) {
+            handler(callback);
+        }
+    }
+    return static_cast<uint32_t>(_due.size());
+}
+
+bool MockSteamBackend::CountsCallbacks() const {
+    return true;
+}
+
+bool MockSteamBackend::HasInterface(SteamInterface which) {
+    std::chrono::microseconds latency;
+    bool available;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _counters.probeCalls++;
+        latency = _script.probeLatency;
+        available = _initialized && which < SteamInterface::Count && !_script.missingInterfaces.test(static_cast<size_t>(which));
+    }
+    Delay(latency);
+    return available;
+}
+
+bool MockSteamBackend::InitManualDispatch() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _manualDispatch = _initialized;
+    return _manualDispatch;
+}
+
+void MockSteamBackend::RunManualFrame() {
+    // Same single-thread rule as RunCallbacks, the frame's callbacks wait in _due
+    std::chrono::microseconds latency;
+    _due.clear();
+    _nextDue = 0;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _counters.manualFrames++;
+        latency = _script.runCallbacksLatency;
+        if (_initialized && _manualDispatch) {
+            while (!_pending.empty() && _pending.front().frame <= _frame) {
+                _due.push_back(std::move(_pending.front().callback));
+                _pending.pop_front();
+            }
+            _counters.callbacksDelivered += _due.size();
+            _frame++;
+        }
+    }
+    Delay(latency);
+}
+
+bool MockSteamBackend::GetNextCallback(SteamCallbackMessage& message) {
+    if (_nextDue >= _due.size()) {
+        return false;
+    }
+    const MockSteamCallback& callback = _due[_nextDue];
+    message.id = callback.id;
+    message.data = callback.payload.data();
+    message.size = static_cast<uint32_t>(callback.payload.size());
+    return true;
+}
+
+void MockSteamBackend::FreeLastCallback() {
+    if (_nextDue < _due.size()) {
+        _nextDue++;
+    }
+}
+
+bool MockSteamBackend::GetCallResult(uint64_t call, void* result, uint32_t size, int resultId, bool& failed) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    failed = false;
+    auto found = _callResults.find(call);
+    // Like Steam, a wrong id or size gets nothing and the result stays where it is
+    if (found == _callResults.end() || found->second.id != resultId || found->second.result.size() != size) {
+        return false;
+    }
+    if (size > 0) {
+        std::memcpy(result, found->second.result.data(), size);
+    }
+    failed = found->second.failed;
+    _counters.callResultsFetched++;
+    _callResults.erase(found);
+    return true;
+}
+
+void MockSteamBackend::Delay(std::chrono::microseconds latency) {
+    if (latency.count() > 0) {
+        std::this_thread::sleep_for(latency);
+    }
+}
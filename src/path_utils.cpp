@@ -0,0 +1,128 @@
+#include "path_utils.hpp"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <mach-o/dyld.h>
+#include <cstdint>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+    struct ResolvedPath {
+        std::string relative;
+        std::string resolved;
+    };
+    using ResolvedTable = std::vector<ResolvedPath>;
+
+    // Only a handful of names ever get resolved (config.ini, the logs, steam_appid.txt),
+    // past this we just stop remembering new ones
+    const size_t kMaxResolvedPaths = 64;
+
+    // Never changed once published, a new entry means a new copy swapped in.
+    // Readers just load the pointer, no lock.
+    std::shared_ptr<const ResolvedTable>& ResolvedPaths() {
+        static std::shared_ptr<const ResolvedTable> table = std::make_shared<const ResolvedTable>();
+        return table;
+    }
+
+    const std::string* FindResolved(const ResolvedTable& table, const std::string& relativePath) {
+        for (const ResolvedPath& entry : table) {
+            if (entry.relative == relativePath) return &entry.resolved;
+        }
+        return nullptr;
+    }
+}
+
+const std::string& PathUtils::GetExecutableDirectory() {
+    static const std::string cachedExeDir = ToUtf8(ToPath(FindExecutablePath()).parent_path());
+    return cachedExeDir;
+}
+
+std::string PathUtils::ResolveRelativeToExecutable(const std::string& relativePath) {
+    if (relativePath.empty()) {
+        return relativePath;
+    }
+
+    std::shared_ptr<const ResolvedTable> table = std::atomic_load(&ResolvedPaths());
+    if (const std::string* resolved = FindResolved(*table, relativePath)) {
+        return *resolved;
+    }
+
+    // If the path is already absolute, return it as-is, otherwise put it next to the executable
+    std::filesystem::path path = ToPath(relativePath);
+    std::string resolved = path.is_absolute() ? relativePath : ToUtf8(ToPath(GetExecutableDirectory()) / path);
+
+    while (table->size() < kMaxResolvedPaths && !FindResolved(*table, relativePath)) {
+        auto grown = std::make_shared<ResolvedTable>(*table);
+        grown->push_back(ResolvedPath{ relativePath, resolved });
+        std::shared_ptr<const ResolvedTable> published = std::move(grown);
+        // On failure table is reloaded with whatever the other thread published, look again
+        if (std::atomic_compare_exchange_strong(&ResolvedPaths(), &table, published)) break;
+    }
+    return resolved;
+}
+
+std::filesystem::path PathUtils::ToPath(std::string_view utf8) {
+    return std::filesystem::u8path(utf8.begin(), utf8.end());
+}
+
+std::string PathUtils::ToUtf8(const std::filesystem::path& path) {
+    return path.u8string();
+}
+
+#ifdef _WIN32
+std::string PathUtils::FindExecutablePath() {
+    // The wide API, GetModuleFileNameA can't return a path outside the ANSI code page
+    std::wstring buffer(MAX_PATH, L'\0');
+    for (;;) {
+        DWORD result = GetModuleFileNameW(NULL, &buffer[0], static_cast<DWORD>(buffer.size()));
+        if (result == 0) {
+            throw std::runtime_error("Failed to get executable path: GetModuleFileNameW failed");
+        }
+        if (result < buffer.size()) {
+            buffer.resize(result);
+            return ToUtf8(std::filesystem::path(buffer));
+        }
+        // Filled the buffer, so it was probably cut short. Long paths go up to 32767 characters
+        if (buffer.size() >= 32768) {
+            throw std::runtime_error("Failed to get executable path: path too long");
+        }
+        buffer.resize(buffer.size() * 2);
+    }
+}
+#elif defined(__APPLE__)
+std::string PathUtils::FindExecutablePath() {
+    uint32_t size = 0;
+    _NSGetExecutablePath(nullptr, &size);
+    std::string buffer(size, '\0');
+    if (_NSGetExecutablePath(&buffer[0], &size) != 0) {
+        throw std::runtime_error("Failed to get executable path: _NSGetExecutablePath failed");
+    }
+    buffer.resize(buffer.find('\0'));
+    return buffer;
+}
+#else
+std::string PathUtils::FindExecutablePath() {
+    std::string buffer(256, '\0');
+    for (;;) {
+        ssize_t result = readlink("/proc/self/exe", &buffer[0], buffer.size());
+        if (result < 0) {
+            throw std::runtime_error("Failed to get executable path: readlink /proc/self/exe failed");
+        }
+        // readlink doesn't say when it cut the path short, only that it filled the buffer
+        if (static_cast<size_t>(result) < buffer.size()) {
+            buffer.resize(static_cast<size_t>(result));
+            return buffer;
+        }
+        if (buffer.size() >= 65536) {
+            throw std::runtime_error("Failed to get executable path: path too long");
+        }
+        buffer.resize(buffer.size() * 2);
+    }
+}
+#endif
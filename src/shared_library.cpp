@@ -0,0 +1,86 @@
+#include "shared_library.hpp"
+#include "path_utils.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+namespace {
+#ifdef _WIN32
+    std::string LastErrorMessage() {
+        DWORD code = GetLastError();
+        char buffer[512] = {};
+        DWORD length = FormatMessageA(FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS, NULL, code, 0,
+                                      buffer, sizeof(buffer), NULL);
+        while (length > 0 && (buffer[length - 1] == '\n' || buffer[length - 1] == '\r' || buffer[length - 1] == ' ')) {
+            length--;
+        }
+        std::string message(buffer, length);
+        return message.empty() ? "error " + std::to_string(code) : message;
+    }
+#endif
+}
+
+SharedLibrary::~SharedLibrary() {
+    Close();
+}
+
+bool SharedLibrary::Open(const std::string& path, std::string& error) {
+    Close();
+#ifdef _WIN32
+    // LOAD_WITH_ALTERED_SEARCH_PATH so the library's own dependencies are looked for next to it
+    HMODULE module = LoadLibraryExW(PathUtils::ToPath(path).c_str(), NULL, LOAD_WITH_ALTERED_SEARCH_PATH);
+    if (!module) {
+        error = path + ": " + LastErrorMessage();
+        return false;
+    }
+    _handle = module;
+#else
+    _handle = dlopen(PathUtils::ToPath(path).c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!_handle) {
+        const char* message = dlerror();
+        error = message ? message : path + ": dlopen failed";
+        return false;
+    }
+#endif
+    _path = path;
+    return true;
+}
+
+void SharedLibrary::Close() {
+    if (!_handle) {
+        return;
+    }
+#ifdef _WIN32
+    FreeLibrary(static_cast<HMODULE>(_handle));
+#else
+    dlclose(_handle);
+#endif
+    _handle = nullptr;
+    _path.clear();
+}
+
+bool SharedLibrary::IsOpen() const {
+    return _handle != nullptr;
+}
+
+const std::string& SharedLibrary::GetPath() const {
+    return _path;
+}
+
+void* SharedLibrary::FindSymbol(const char* name) const {
+    if (!_handle) {
+        return nullptr;
+    }
+#ifdef _WIN32
+    return reinterpret_cast<void*>(GetProcAddress(static_cast<HMODULE>(_handle), name));
+#else
+    return dlsym(_handle, name);
+#endif
+}
+
+void SharedLibrary::Release() {
+    _handle = nullptr;
+}
@@ -0,0 +1,249 @@
+#include "startup_tracer.hpp"
+#include "atomic_file.hpp"
+#include "path_utils.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+void LatencyHistogram::Add(uint64_t micros, uint64_t count) {
+    _buckets[BucketOf(micros)] += count;
+    _count += count;
+}
+
+uint64_t LatencyHistogram::Percentile(double p) const {
+    if (_count == 0) {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(std::ceil(p * static_cast<double>(_count)));
+    rank = std::max<uint64_t>(1, std::min(rank, _count));
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < kBucketCount; bucket++) {
+        seen += _buckets[bucket];
+        if (seen >= rank) {
+            // Middle of the bucket, the best guess at where its samples were
+            return LowerBound(bucket) + Width(bucket) / 2;
+        }
+    }
+    return LowerBound(kBucketCount - 1);
+}
+
+std::string LatencyHistogram::Serialize() const {
+    std::string text;
+    for (size_t bucket = 0; bucket < kBucketCount; bucket++) {
+        if (_buckets[bucket] == 0) continue;
+        if (!text.empty()) text += ' ';
+        text += std::to_string(bucket);
+        text += ':';
+        text += std::to_string(_buckets[bucket]);
+    }
+    return text;
+}
+
+bool LatencyHistogram::Deserialize(const std::string& text) {
+    std::istringstream stream(text);
+    std::string pair;
+    while (stream >> pair) {
+        size_t colon = pair.find(':');
+        if (colon == std::string::npos) {
+            return false;
+        }
+        try {
+            size_t bucket = std::stoul(pair.substr(0, colon));
+            uint64_t count = std::stoull(pair.substr(colon + 1));
+            if (bucket >= kBucketCount) {
+                return false;
+            }
+            _buckets[bucket] += count;
+            _count += count;
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t LatencyHistogram::BucketOf(uint64_t micros) {
+    if (micros < 8) {
+        return static_cast<size_t>(micros);
+    }
+    unsigned exponent = 0;
+    while ((micros >> (exponent + 1)) != 0) {
+        exponent++;
+    }
+    size_t sub = static_cast<size_t>((micros >> (exponent - 3)) & 7);
+    return std::min<size_t>((exponent - 2) * 8 + sub, kBucketCount - 1);
+}
+
+uint64_t LatencyHistogram::LowerBound(size_t bucket) {
+    if (bucket < 8) {
+        return bucket;
+    }
+    unsigned exponent = static_cast<unsigned>(bucket / 8 + 2);
+    return (8 + static_cast<uint64_t>(bucket % 8)) << (exponent - 3);
+}
+
+uint64_t LatencyHistogram::Width(size_t bucket) {
+    if (bucket < 8) {
+        return 1;
+    }
+    return uint64_t(1) << (bucket / 8 - 1);
+}
+
+namespace {
+    uint64_t ToMicros(StartupTracer::Clock::duration duration) {
+        auto micros = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+        return micros > 0 ? static_cast<uint64_t>(micros) : 0;
+    }
+
+    std::string FormatMs(uint64_t micros) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.3f ms", static_cast<double>(micros) / 1000.0);
+        return buffer;
+    }
+
+    std::string FormatMicros(StartupTracer::Clock::duration duration) {
+        // Chrome wants microseconds, fractions allowed
+        auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.3f", static_cast<double>(nanos) / 1000.0);
+        return buffer;
+    }
+}
+
+StartupTracer::StartupTracer() : _origin(Clock::now()) {
+    _spans.reserve(32);
+    _threads.push_back(std::this_thread::get_id());
+}
+
+void StartupTracer::Record(const char* name, Clock::time_point start, Clock::time_point end) {
+    std::thread::id id = std::this_thread::get_id();
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto thread = std::find(_threads.begin(), _threads.end(), id);
+    if (thread == _threads.end()) {
+        thread = _threads.insert(_threads.end(), id);
+    }
+    _spans.push_back(Span{ name, start, end - start, static_cast<uint32_t>(thread - _threads.begin()) + 1 });
+}
+
+std::vector<StartupTracer::Span> StartupTracer::GetSpans() const {
+    std::vector<Span> spans;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        spans = _spans;
+    }
+    // Recorded when they end, shown in the order they started
+    std::stable_sort(spans.begin(), spans.end(), [](const Span& a, const Span& b) { return a.start < b.start; });
+    return spans;
+}
+
+bool StartupTracer::WriteChromeTrace(const std::string& path) const {
+    std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    for (const Span& span : GetSpans()) {
+        if (!first) json += ",\n";
+        first = false;
+        // Span names are identifiers from our own code, nothing in them needs escaping
+        json += "{\"name\":\"";
+        json += span.name;
+        json += "\",\"cat\":\"startup\",\"ph\":\"X\",\"pid\":1,\"tid\":";
+        json += std::to_string(span.thread);
+        json += ",\"ts\":";
+        json += FormatMicros(span.start - _origin);
+        json += ",\"dur\":";
+        json += FormatMicros(span.duration);
+        json += "}";
+    }
+    json += "\n]}\n";
+
+    if (!AtomicFileWriter(false).Write(path, json)) {
+        std::cerr << "Failed to write startup trace: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool StartupTracer::UpdateStats(const std::string& path, const std::string& version, std::vector<PhaseStats>& stats) const {
+    // Two launchers exiting together would otherwise both add to the same old file
+    FileLock lock(path);
+
+    // Lines for other versions are carried over untouched, ours get merged
+    std::vector<std::string> otherLines;
+    std::map<std::string, LatencyHistogram> phases;
+    std::ifstream in(PathUtils::ToPath(path));
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream fields(line);
+        std::string lineVersion, phase, buckets;
+        if (!(fields >> lineVersion >> phase)) continue;
+        if (lineVersion != version) {
+            otherLines.push_back(line);
+            continue;
+        }
+        std::getline(fields, buckets);
+        if (!phases[phase].Deserialize(buckets)) {
+            std::cerr << "Ignoring bad line in startup stats: " << line << std::endl;
+            phases.erase(phase);
+        }
+    }
+    in.close();
+
+    std::vector<Span> spans = GetSpans();
+    for (const Span& span : spans) {
+        phases[span.name].Add(ToMicros(span.duration));
+    }
+
+    std::string text = "# uc-online startup histograms, one line per version and phase: <version> <phase> <bucket>:<count>...\n";
+    for (const std::string& other : otherLines) {
+        text += other;
+        text += '\n';
+    }
+    stats.clear();
+    for (const auto& phase : phases) {
+        text += version + ' ' + phase.first + ' ' + phase.second.Serialize() + '\n';
+    }
+    // Only the phases this run went through, in that order
+    for (const Span& span : spans) {
+        bool listed = std::any_of(stats.begin(), stats.end(), [&](const PhaseStats& s) { return s.name == span.name; });
+        if (!listed) {
+            const LatencyHistogram& histogram = phases[span.name];
+            stats.push_back(PhaseStats{ span.name, histogram.GetCount(), histogram.Percentile(0.50), histogram.Percentile(0.95), histogram.Percentile(0.99) });
+        }
+    }
+
+    if (!AtomicFileWriter(false).Write(path, text)) {
+        std::cerr << "Failed to write startup stats: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::string StartupTracer::FormatSummary(const std::vector<PhaseStats>& stats) const {
+    std::vector<Span> spans = GetSpans();
+    size_t nameWidth = 5;
+    for (const Span& span : spans) {
+        nameWidth = std::max(nameWidth, std::string(span.name).size());
+    }
+
+    char row[256];
+    std::string table;
+    std::snprintf(row, sizeof(row), "%-*s %12s %12s %12s %12s %6s\n", static_cast<int>(nameWidth), "phase", "this run", "p50", "p95", "p99", "runs");
+    table += row;
+    for (const Span& span : spans) {
+        uint64_t micros = ToMicros(span.duration);
+        auto phase = std::find_if(stats.begin(), stats.end(), [&](const PhaseStats& s) { return s.name == span.name; });
+        if (phase != stats.end()) {
+            std::snprintf(row, sizeof(row), "%-*s %12s %12s %12s %12s %6llu\n", static_cast<int>(nameWidth), span.name,
+                          FormatMs(micros).c_str(), FormatMs(phase->p50Us).c_str(), FormatMs(phase->p95Us).c_str(),
+                          FormatMs(phase->p99Us).c_str(), static_cast<unsigned long long>(phase->runs));
+        } else {
+            std::snprintf(row, sizeof(row), "%-*s %12s\n", static_cast<int>(nameWidth), span.name, FormatMs(micros).c_str());
+        }
+        table += row;
+    }
+    return table;
+}
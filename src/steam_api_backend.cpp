@@ -0,0 +1,253 @@
+#include "steam_api_backend.hpp"
+#include <steam/steam_api.h>
+#include <steam/steam_gameserver.h>
+#include <cstddef>
+
+static_assert(static_cast<int>(SteamInitResult::VersionMismatch) == k_ESteamAPIInitResult_VersionMismatch,
+              "SteamInitResult has to match ESteamAPIInitResult");
+static_assert(SteamApiCallCompleted::kCallbackId == SteamAPICallCompleted_t::k_iCallback &&
+              sizeof(SteamApiCallCompleted) == sizeof(SteamAPICallCompleted_t) &&
+              offsetof(SteamApiCallCompleted, resultId) == offsetof(SteamAPICallCompleted_t, m_iCallback) &&
+              offsetof(SteamApiCallCompleted, resultSize) == offsetof(SteamAPICallCompleted_t, m_cubParam),
+              "SteamApiCallCompleted has to match SteamAPICallCompleted_t");
+
+// Only the flat exports, none of the SDK's inline helpers (SteamAPI_InitEx, SteamUser()...),
+// those would call into the import library and put steam_api back on the link line
+struct SteamApiBackend::Functions {
+    ESteamAPIInitResult (S_CALLTYPE* init)(const char* interfaceVersions, SteamErrMsg* errorMsg);
+    void (S_CALLTYPE* shutdown)();
+    bool (S_CALLTYPE* restartAppIfNecessary)(uint32 appId);
+    void (S_CALLTYPE* runCallbacks)();
+    HSteamUser (S_CALLTYPE* getHSteamUser)();
+    HSteamUser (S_CALLTYPE* getGameServerHSteamUser)();
+    void* (S_CALLTYPE* findOrCreateUserInterface)(HSteamUser user, const char* version);
+    void* (S_CALLTYPE* findOrCreateGameServerInterface)(HSteamUser user, const char* version);
+    void* (S_CALLTYPE* createInterface)(const char* version);
+
+    // Optional, null in a steam_api from before manual dispatch
+    HSteamPipe (S_CALLTYPE* getHSteamPipe)();
+    void (S_CALLTYPE* manualDispatchInit)();
+    void (S_CALLTYPE* manualDispatchRunFrame)(HSteamPipe pipe);
+    bool (S_CALLTYPE* manualDispatchGetNextCallback)(HSteamPipe pipe, CallbackMsg_t* message);
+    void (S_CALLTYPE* manualDispatchFreeLastCallback)(HSteamPipe pipe);
+    bool (S_CALLTYPE* manualDispatchGetAPICallResult)(HSteamPipe pipe, SteamAPICall_t call, void* result, int size, int expectedId, bool* failed);
+};
+
+namespace {
+    // Same order as the members of SteamApiBackend::Functions
+    const char* const kSymbols[] = {
+        "SteamInternal_SteamAPI_Init",
+        "SteamAPI_Shutdown",
+        "SteamAPI_RestartAppIfNecessary",
+        "SteamAPI_RunCallbacks",
+        "SteamAPI_GetHSteamUser",
+        "SteamGameServer_GetHSteamUser",
+        "SteamInternal_FindOrCreateUserInterface",
+        "SteamInternal_FindOrCreateGameServerInterface",
+        "SteamInternal_CreateInterface",
+    };
+    const size_t kSymbolCount = sizeof(kSymbols) / sizeof(kSymbols[0]);
+
+    // Nobody needs these unless ManualCallbackDispatch is on, so they don't fail Load()
+    const char* const kManualDispatchSymbols[] = {
+        "SteamAPI_GetHSteamPipe",
+        "SteamAPI_ManualDispatch_Init",
+        "SteamAPI_ManualDispatch_RunFrame",
+        "SteamAPI_ManualDispatch_GetNextCallback",
+        "SteamAPI_ManualDispatch_FreeLastCallback",
+        "SteamAPI_ManualDispatch_GetAPICallResult",
+    };
+    const size_t kManualDispatchSymbolCount = sizeof(kManualDispatchSymbols) / sizeof(kManualDispatchSymbols[0]);
+
+    // What SteamAPI_InitEx passes, so the dll checks it supports every interface our headers know
+    const char kInterfaceVersions[] =
+        STEAMUTILS_INTERFACE_VERSION "\0"
+        STEAMNETWORKINGUTILS_INTERFACE_VERSION "\0"
+        STEAMAPPS_INTERFACE_VERSION "\0"
+        STEAMCONTROLLER_INTERFACE_VERSION "\0"
+        STEAMFRIENDS_INTERFACE_VERSION "\0"
+        STEAMHTMLSURFACE_INTERFACE_VERSION "\0"
+        STEAMHTTP_INTERFACE_VERSION "\0"
+        STEAMINPUT_INTERFACE_VERSION "\0"
+        STEAMINVENTORY_INTERFACE_VERSION "\0"
+        STEAMMATCHMAKINGSERVERS_INTERFACE_VERSION "\0"
+        STEAMMATCHMAKING_INTERFACE_VERSION "\0"
+        STEAMMUSIC_INTERFACE_VERSION "\0"
+        STEAMNETWORKINGMESSAGES_INTERFACE_VERSION "\0"
+        STEAMNETWORKINGSOCKETS_INTERFACE_VERSION "\0"
+        STEAMNETWORKING_INTERFACE_VERSION "\0"
+        STEAMPARENTALSETTINGS_INTERFACE_VERSION "\0"
+        STEAMPARTIES_INTERFACE_VERSION "\0"
+        STEAMREMOTEPLAY_INTERFACE_VERSION "\0"
+        STEAMREMOTESTORAGE_INTERFACE_VERSION "\0"
+        STEAMSCREENSHOTS_INTERFACE_VERSION "\0"
+        STEAMUGC_INTERFACE_VERSION "\0"
+        STEAMUSERSTATS_INTERFACE_VERSION "\0"
+        STEAMUSER_INTERFACE_VERSION "\0"
+        STEAMVIDEO_INTERFACE_VERSION "\0"
+        "\0";
+
+    template <typename Function>
+    void Bind(Function& function, void* address) {
+        function = reinterpret_cast<Function>(address);
+    }
+}
+
+SteamApiBackend::SteamApiBackend() {
+}
+
+SteamApiBackend::~SteamApiBackend() {
+    // steam_api keeps threads of its own running after init, unloading it under them crashes
+    if (_initialized) {
+        _library.Release();
+    }
+}
+
+bool SteamApiBackend::Load(const std::string& libraryPath, std::string& error) {
+    if (_functions) {
+        return true;
+    }
+
+    if (!_library.Open(libraryPath, error)) {
+        return false;
+    }
+
+    void* addresses[kSymbolCount] = {};
+    std::string missing;
+    for (size_t i = 0; i < kSymbolCount; i++) {
+        addresses[i] = _library.FindSymbol(kSymbols[i]);
+        if (!addresses[i]) {
+            missing += missing.empty() ? kSymbols[i] : std::string(", ") + kSymbols[i];
+        }
+    }
+    if (!missing.empty()) {
+        // Probably an old or mismatched steam_api, better to stop here than crash on the first call
+        error = libraryPath + " is missing " + missing;
+        _library.Close();
+        return false;
+    }
+
+    std::unique_ptr<Functions> functions(new Functions());
+    size_t next = 0;
+    Bind(functions->init, addresses[next++]);
+    Bind(functions->shutdown, addresses[next++]);
+    Bind(functions->restartAppIfNecessary, addresses[next++]);
+    Bind(functions->runCallbacks, addresses[next++]);
+    Bind(functions->getHSteamUser, addresses[next++]);
+    Bind(functions->getGameServerHSteamUser, addresses[next++]);
+    Bind(functions->findOrCreateUserInterface, addresses[next++]);
+    Bind(functions->findOrCreateGameServerInterface, addresses[next++]);
+    Bind(functions->createInterface, addresses[next++]);
+
+    void* manual[kManualDispatchSymbolCount] = {};
+    bool hasManual = true;
+    for (size_t i = 0; i < kManualDispatchSymbolCount; i++) {
+        manual[i] = _library.FindSymbol(kManualDispatchSymbols[i]);
+        hasManual = hasManual && manual[i] != nullptr;
+    }
+    if (hasManual) {
+        next = 0;
+        Bind(functions->getHSteamPipe, manual[next++]);
+        Bind(functions->manualDispatchInit, manual[next++]);
+        Bind(functions->manualDispatchRunFrame, manual[next++]);
+        Bind(functions->manualDispatchGetNextCallback, manual[next++]);
+        Bind(functions->manualDispatchFreeLastCallback, manual[next++]);
+        Bind(functions->manualDispatchGetAPICallResult, manual[next++]);
+    }
+    _functions = std::move(functions);
+    return true;
+}
+
+bool SteamApiBackend::RestartAppIfNecessary(uint32_t appId) {
+    return _functions && _functions->restartAppIfNecessary(appId);
+}
+
+SteamInitResult SteamApiBackend::Init(std::string& error) {
+    if (!_functions) {
+        error = "steam_api is not loaded";
+        return SteamInitResult::FailedGeneric;
+    }
+
+    SteamErrMsg errorMsg = {};
+    ESteamAPIInitResult result = _functions->init(kInterfaceVersions, &errorMsg);
+    if (result != k_ESteamAPIInitResult_OK) {
+        error = errorMsg;
+    } else {
+        _initialized = true;
+    }
+    return static_cast<SteamInitResult>(result);
+}
+
+void SteamApiBackend::Shutdown() {
+    if (_functions) {
+        _functions->shutdown();
+    }
+}
+
+uint32_t SteamApiBackend::RunCallbacks() {
+    // SteamAPI_RunCallbacks doesn't say how many it ran
+    if (_functions) {
+        _functions->runCallbacks();
+    }
+    return 0;
+}
+
+bool SteamApiBackend::CountsCallbacks() const {
+    return false;
+}
+
+bool SteamApiBackend::HasInterface(SteamInterface which) {
+    if (!_functions) {
+        return false;
+    }
+
+    const Functions& f = *_functions;
+    switch (which) {
+        case SteamInterface::User: return f.findOrCreateUserInterface(f.getHSteamUser(), STEAMUSER_INTERFACE_VERSION) != nullptr;
+        case SteamInterface::Apps: return f.findOrCreateUserInterface(f.getHSteamUser(), STEAMAPPS_INTERFACE_VERSION) != nullptr;
+        case SteamInterface::GameServer: return f.findOrCreateGameServerInterface(f.getGameServerHSteamUser(), STEAMGAMESERVER_INTERFACE_VERSION) != nullptr;
+        case SteamInterface::UGC: return f.findOrCreateUserInterface(f.getHSteamUser(), STEAMUGC_INTERFACE_VERSION) != nullptr;
+        case SteamInterface::HTTP: return f.findOrCreateUserInterface(f.getHSteamUser(), STEAMHTTP_INTERFACE_VERSION) != nullptr;
+        case SteamInterface::Networking: return f.findOrCreateUserInterface(f.getHSteamUser(), STEAMNETWORKING_INTERFACE_VERSION) != nullptr;
+        case SteamInterface::Client: return f.createInterface(STEAMCLIENT_INTERFACE_VERSION) != nullptr;
+        case SteamInterface::Count: break;
+    }
+    return false;
+}
+
+bool SteamApiBackend::InitManualDispatch() {
+    if (!_functions || !_initialized || !_functions->manualDispatchInit) {
+        return false;
+    }
+    _functions->manualDispatchInit();
+    _pipe = _functions->getHSteamPipe();
+    return _pipe != 0;
+}
+
+void SteamApiBackend::RunManualFrame() {
+    if (_pipe) {
+        _functions->manualDispatchRunFrame(_pipe);
+    }
+}
+
+bool SteamApiBackend::GetNextCallback(SteamCallbackMessage& message) {
+    CallbackMsg_t callback;
+    if (!_pipe || !_functions->manualDispatchGetNextCallback(_pipe, &callback)) {
+        return false;
+    }
+    message.id = callback.m_iCallback;
+    message.data = callback.m_pubParam;
+    message.size = callback.m_cubParam > 0 ? static_cast<uint32_t>(callback.m_cubParam) : 0;
+    return true;
+}
+
+void SteamApiBackend::FreeLastCallback() {
+    if (_pipe) {
+        _functions->manualDispatchFreeLastCallback(_pipe);
+    }
+}
+
+bool SteamApiBackend::GetCallResult(uint64_t call, void* result, uint32_t size, int resultId, bool& failed) {
+    failed = false;
+    return _pipe && _functions->manualDispatchGetAPICallResult(_pipe, call, result, static_cast<int>(size), resultId, &failed);
+}
@@ -0,0 +1,15 @@
+#include "steam_backend.hpp"
+
+const char* SteamInterfaceName(SteamInterface which) {
+    switch (which) {
+        case SteamInterface::User: return "SteamUser";
+        case SteamInterface::Apps: return "SteamApps";
+        case SteamInterface::GameServer: return "SteamGameServer";
+        case SteamInterface::UGC: return "SteamUGC";
+        case SteamInterface::HTTP: return "SteamHTTP";
+        case SteamInterface::Networking: return "SteamNetworking";
+        case SteamInterface::Client: return "SteamClient";
+        case SteamInterface::Count: break;
+    }
+    return "unknown";
+}
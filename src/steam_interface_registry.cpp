@@ -0,0 +1,129 @@
+#include "steam_interface_registry.hpp"
+#include <exception>
+#include <iostream>
+
+namespace {
+    // Span names, the same the old InitializeSteam* functions had so the startup stats carry on
+    const char* const kProbeSpanNames[] = {
+        "InitializeSteamUser",
+        "InitializeSteamApps",
+        "InitializeSteamGameServer",
+        "InitializeSteamUGC",
+        "InitializeSteamHTTP",
+        "InitializeSteamNetworking",
+        "InitializeSteamClient",
+    };
+    static_assert(sizeof(kProbeSpanNames) / sizeof(kProbeSpanNames[0]) == static_cast<size_t>(SteamInterface::Count),
+                  "one span name per SteamInterface");
+
+    uint32_t Bit(SteamInterface which) {
+        return uint32_t(1) << static_cast<uint32_t>(which);
+    }
+}
+
+SteamInterfaceRegistry::SteamInterfaceRegistry(std::shared_ptr<SteamBackend> steam, StartupTracer* tracer)
+    : _steam(std::move(steam)), _tracer(tracer) {
+}
+
+SteamInterfaceRegistry::~SteamInterfaceRegistry() {
+    Wait();
+}
+
+void SteamInterfaceRegistry::SetResultHandler(ResultHandler handler) {
+    std::lock_guard<std::mutex> lock(_handlerMutex);
+    _handler = std::move(handler);
+}
+
+bool SteamInterfaceRegistry::ProbeRequired() {
+    bool allThere = true;
+    for (const SteamInterfaceSpec& spec : kSteamInterfaceSpecs) {
+        if (spec.use == InterfaceUse::Required && !IsAvailable(spec.which)) {
+            allThere = false;
+        }
+    }
+    return allThere;
+}
+
+void SteamInterfaceRegistry::ProbeOptionalAsync() {
+    std::lock_guard<std::mutex> lock(_threadMutex);
+    if (_optionalStarted) {
+        return;
+    }
+    _optionalStarted = true;
+    _thread = std::thread([this]() {
+        for (const SteamInterfaceSpec& spec : kSteamInterfaceSpecs) {
+            if (spec.use == InterfaceUse::Optional) {
+                IsAvailable(spec.which);
+            }
+        }
+    });
+}
+
+void SteamInterfaceRegistry::Wait() {
+    std::lock_guard<std::mutex> lock(_threadMutex);
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+void SteamInterfaceRegistry::Reset() {
+    std::lock_guard<std::mutex> lock(_threadMutex);
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+    _optionalStarted = false;
+    _probed = 0;
+    _available = 0;
+}
+
+bool SteamInterfaceRegistry::IsAvailable(SteamInterface which) {
+    if (which >= SteamInterface::Count) {
+        return false;
+    }
+    uint32_t bit = Bit(which);
+    if (_probed.load(std::memory_order_acquire) & bit) {
+        return (_available.load(std::memory_order_acquire) & bit) != 0;
+    }
+    // Two threads asking at once both probe, harmless since Steam gives the same answer twice
+    return Probe(which);
+}
+
+SteamInterfaceRegistry::Mask SteamInterfaceRegistry::GetProbed() const {
+    return Mask(_probed.load(std::memory_order_acquire));
+}
+
+SteamInterfaceRegistry::Mask SteamInterfaceRegistry::GetAvailable() const {
+    return Mask(_available.load(std::memory_order_acquire));
+}
+
+bool SteamInterfaceRegistry::Probe(SteamInterface which) {
+    bool available = false;
+    try {
+        if (_tracer) {
+            available = _tracer->Time(kProbeSpanNames[static_cast<size_t>(which)], [&] { return _steam->HasInterface(which); });
+        } else {
+            available = _steam->HasInterface(which);
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << "Error probing " << SteamInterfaceName(which) << ": " << ex.what() << std::endl;
+    }
+
+    uint32_t bit = Bit(which);
+    if (available) {
+        _available.fetch_or(bit, std::memory_order_release);
+    }
+    // Published last, so anyone who sees it probed also sees the answer
+    uint32_t before = _probed.fetch_or(bit, std::memory_order_acq_rel);
+
+    if (!(before & bit)) {
+        ResultHandler handler;
+        {
+            std::lock_guard<std::mutex> lock(_handlerMutex);
+            handler = _handler;
+        }
+        if (handler) {
+            handler(which, kSteamInterfaceSpecs[static_cast<size_t>(which)].use, available);
+        }
+    }
+    return available;
+}
@@ -0,0 +1,83 @@
+#include "timestamp_formatter.hpp"
+#include <cstring>
+#include <ctime>
+#include <limits>
+
+namespace {
+    void WriteDigits(char* out, int value, int width) {
+        for (int i = width - 1; i >= 0; i--) {
+            out[i] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+    }
+}
+
+TimestampFormatter::TimestampFormatter(TimestampPrecision precision, TimestampClock clock)
+    : _precision(precision), _clock(clock),
+      _systemOrigin(std::chrono::system_clock::now()), _steadyOrigin(std::chrono::steady_clock::now()),
+      _cachedSecond(std::numeric_limits<int64_t>::min()), _cachedMinuteStart(std::numeric_limits<int64_t>::min()) {
+    std::memcpy(_cached, "0000-00-00 00:00:00", sizeof(_cached));
+}
+
+std::chrono::system_clock::time_point TimestampFormatter::Now() const {
+    if (_clock == TimestampClock::Monotonic) {
+        auto elapsed = std::chrono::steady_clock::now() - _steadyOrigin;
+        return _systemOrigin + std::chrono::duration_cast<std::chrono::system_clock::duration>(elapsed);
+    }
+    return std::chrono::system_clock::now();
+}
+
+size_t TimestampFormatter::Format(char* buffer) {
+    return Format(buffer, Now());
+}
+
+size_t TimestampFormatter::Format(char* buffer, std::chrono::system_clock::time_point time) {
+    int64_t micros = std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+    int64_t second = micros / 1000000;
+    int64_t fraction = micros % 1000000;
+    if (fraction < 0) {
+        second -= 1;
+        fraction += 1000000;
+    }
+
+    if (second != _cachedSecond) {
+        if (second >= _cachedMinuteStart && second < _cachedMinuteStart + 60) {
+            WriteDigits(_cached + 17, static_cast<int>(second - _cachedMinuteStart), 2);
+        } else {
+            FormatSecond(second);
+        }
+        _cachedSecond = second;
+    }
+
+    std::memcpy(buffer, _cached, sizeof(_cached));
+    size_t length = sizeof(_cached);
+
+    if (_precision == TimestampPrecision::Milliseconds) {
+        buffer[length++] = '.';
+        WriteDigits(buffer + length, static_cast<int>(fraction / 1000), 3);
+        length += 3;
+    } else if (_precision == TimestampPrecision::Microseconds) {
+        buffer[length++] = '.';
+        WriteDigits(buffer + length, static_cast<int>(fraction), 6);
+        length += 6;
+    }
+    return length;
+}
+
+void TimestampFormatter::FormatSecond(int64_t second) {
+    std::time_t t = static_cast<std::time_t>(second);
+    std::tm tm;
+#ifdef _WIN32
+    localtime_s(&tm, &t);
+#else
+    localtime_r(&t, &tm);
+#endif
+
+    WriteDigits(_cached, tm.tm_year + 1900, 4);
+    WriteDigits(_cached + 5, tm.tm_mon + 1, 2);
+    WriteDigits(_cached + 8, tm.tm_mday, 2);
+    WriteDigits(_cached + 11, tm.tm_hour, 2);
+    WriteDigits(_cached + 14, tm.tm_min, 2);
+    WriteDigits(_cached + 17, tm.tm_sec, 2);
+    _cachedMinuteStart = second - tm.tm_sec;
+}
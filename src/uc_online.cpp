@@ -1,119 +1,431 @@
 #include "uc_online.hpp"
+#include "steam_callback_dispatcher.hpp"
+#include <steam/isteamuser.h>
+#include <steam/isteamutils.h>
 #include <iostream>
 #include <fstream>
 #include <filesystem>
 #include <thread>
 #include <chrono>
+#include <future>
+#include <algorithm>
+
+#ifndef UC_ONLINE_VERSION
+#define UC_ONLINE_VERSION "dev"
+#endif
+
+#ifdef _WIN32
 #include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <csignal>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+// The callbacks the launcher itself cares about under ManualCallbackDispatch. They run
+// on the pump's thread, like everything SteamAPI_RunCallbacks would have called
+template <typename Traits>
+struct UCOnlineLauncher<Traits>::CallbackDispatch {
+    using Launcher = UCOnlineLauncher<Traits>;
+
+    static void OnServersConnected(Launcher& launcher, const SteamServersConnected_t&) {
+        launcher._logger->Info("Connected to the Steam servers");
+    }
+
+    static void OnServerConnectFailure(Launcher& launcher, const SteamServerConnectFailure_t& callback) {
+        launcher._logger->Warning("Could not connect to the Steam servers (EResult ", static_cast<int>(callback.m_eResult), ")",
+                                  callback.m_bStillRetrying ? ", still trying" : "");
+    }
+
+    static void OnServersDisconnected(Launcher& launcher, const SteamServersDisconnected_t& callback) {
+        launcher._logger->Warning("Lost the connection to the Steam servers (EResult ", static_cast<int>(callback.m_eResult), ")");
+    }
+
+    static void OnSteamShutdown(Launcher& launcher, const SteamShutdown_t&) {
+        // Nothing left to stay open for
+        launcher._logger->Info("Steam is shutting down");
+        launcher.RequestExit();
+    }
+
+    static constexpr SteamCallbackTable<Launcher, 4> kTable{ std::array<SteamCallbackRoute<Launcher>, 4>{ {
+        MakeCallbackRoute<Launcher, SteamServersConnected_t, &OnServersConnected>(),
+        MakeCallbackRoute<Launcher, SteamServerConnectFailure_t, &OnServerConnectFailure>(),
+        MakeCallbackRoute<Launcher, SteamServersDisconnected_t, &OnServersDisconnected>(),
+        MakeCallbackRoute<Launcher, SteamShutdown_t, &OnSteamShutdown>(),
+    } } };
+    static_assert(kTable.IsValid(), "duplicate callback in the launcher's table");
+
+    SteamCallbackDispatcher<Launcher, 4> dispatcher;
+
+    CallbackDispatch(SteamBackend& steam, Launcher& launcher) : dispatcher(steam, launcher, kTable) {
+    }
+};
+
+template <typename Traits>
+UCOnlineLauncher<Traits>::UCOnlineLauncher(std::shared_ptr<SteamBackend> steam, const std::string& iniFilePath,
+                                           const ConfigOverrides& commandLine)
+    : _steam(std::move(steam)), _interfaces(_steam, &_tracer), _environment(ConfigOverrides::FromEnvironment()), _commandLine(commandLine) {
+    // --config beats UC_ONLINE_CONFIG beats the path we were given
+    std::string gameConfigPath = iniFilePath;
+    if (!_commandLine.configPath.empty()) {
+        gameConfigPath = _commandLine.configPath;
+    } else if (!_environment.configPath.empty()) {
+        gameConfigPath = _environment.configPath;
+    }
+    _config = _tracer.Time("IniConfig", [&] { return std::make_unique<IniConfig>(gameConfigPath); });
+    _machineConfig = _tracer.Time("MachineConfig", [] { return LayeredConfig::LoadMachineConfig(); });
+    ResolveConfig();
+
+    const LauncherSettings& settings = _resolved->GetSettings();
+    _currentAppID = settings.Get<ConfigKey::AppID>();
+    _gameExecutable = PathUtils::ToUtf8(settings.Get<ConfigKey::GameExecutable>());
+    _gameArguments = settings.Get<ConfigKey::GameArguments>();
+    _steamApiDllPath = PathUtils::ToUtf8(settings.Get<ConfigKey::SteamApiDLLPath>());
+
+    _logger = _tracer.Time("Logger", [&] {
+        return std::make_unique<Logger>(PathUtils::ToUtf8(settings.Get<ConfigKey::LogFile>()), settings.Get<ConfigKey::EnableLogging>(), LoggerOptions::FromSettings(settings));
+    });
+    for (const std::string& error : settings.GetErrors()) {
+        _logger->Warning("config: ", error);
+    }
+    if (_machineConfig) {
+        _logger->Info("Machine config: ", _machineConfig->GetFilePath());
+    }
+
+    _logger->Info(Traits::kName, " initialized with appid: ", _currentAppID, " (from ", ConfigLayerName(_resolved->GetSource(ConfigKey::AppID)), ")");
+    _logger->Info("Game executable: ", _gameExecutable.empty() ? std::string_view("not configured") : _gameExecutable);
+    _logger->Info(Traits::kSteamApiLibrary, " path: ", GetSteamApiLibraryPath());
+
+    _interfaces.SetResultHandler([this](SteamInterface which, InterfaceUse use, bool available) {
+        LogInterfaceProbe(which, use, available);
+    });
+
+    if (settings.Get<ConfigKey::WatchConfig>()) {
+        StartConfigWatcher();
+    }
+}
 
-UCOnline::UCOnline(const std::string& iniFilePath) {
-    _config = std::make_unique<IniConfig>(iniFilePath);
-    _currentAppID = _config->GetAppID();
-    _gameExecutable = _config->GetGameExecutable();
-    _gameArguments = _config->GetGameArguments();
-    _steamApiDllPath = _config->GetSteamApiDllPath();
+template <typename Traits>
+void UCOnlineLauncher<Traits>::StartConfigWatcher() {
+    _configWatcher = std::make_unique<ConfigWatcher>(_config->GetFilePath());
+    if (!_configWatcher->IsWatching()) {
+        _logger->Warning("Could not watch config.ini for changes, edits need a restart");
+        _configWatcher.reset();
+        return;
+    }
 
-    std::string logFile = _config->GetValue("Logging", "LogFile", "uc_online.log");
-    bool enableLogging = _config->GetValue("Logging", "EnableLogging", "true") == "true";
-    _logger = std::make_unique<Logger>(logFile, enableLogging);
+    // Runs on the watcher thread. The logger is safe to poke from here, everything
+    // else is taken from the same snapshot by the main thread in ApplyConfigChanges(),
+    // which WaitForExit() gets around to once woken
+    _configWatcher->Subscribe([this](const IniConfig& config) {
+        LayeredConfig resolved(_machineConfig.get(), config, _environment, _commandLine);
+        const LauncherSettings& settings = resolved.GetSettings();
+        if (settings.Get<ConfigKey::EnableLogging>() != _logger->IsLoggingEnabledA()) {
+            _logger->SetLoggingEnabled(settings.Get<ConfigKey::EnableLogging>());
+        }
+        _logger->SetLogFilePath(PathUtils::ToUtf8(settings.Get<ConfigKey::LogFile>()));
+        _logger->Info("config.ini changed on disk");
+        for (const std::string& error : settings.GetErrors()) {
+            _logger->Warning("config: ", error);
+        }
+        _exitEvents.Wake();
+    });
+}
+
+template <typename Traits>
+void UCOnlineLauncher<Traits>::ResolveConfig() {
+    _resolved = std::make_shared<const LayeredConfig>(_machineConfig.get(), *_config, _environment, _commandLine);
+}
 
-    _logger->Log("uc-online initialized with appid: " + std::to_string(_currentAppID));
-    _logger->Log("Game executable: " + (_gameExecutable.empty() ? "not configured" : _gameExecutable));
-    _logger->Log("steam_api.dll path: " + (_steamApiDllPath.empty() ? "default loading" : _steamApiDllPath));
+template <typename Traits>
+std::string UCOnlineLauncher<Traits>::GetSteamApiLibraryPath() const {
+    // SteamApiDLLPath is the folder the library is in, relative to the launcher (empty = next to it).
+    // A path straight to the file works too
+    if (_steamApiDllPath.empty()) {
+        return PathUtils::ResolveRelativeToExecutable(Traits::kSteamApiLibrary);
+    }
+    std::filesystem::path path = PathUtils::ToPath(PathUtils::ResolveRelativeToExecutable(_steamApiDllPath));
+    if (path.has_extension() && (path.extension() == ".dll" || path.extension() == ".so" || path.extension() == ".dylib")) {
+        return PathUtils::ToUtf8(path);
+    }
+    return PathUtils::ToUtf8(path / Traits::kSteamApiLibrary);
 }
 
-UCOnline::~UCOnline() {
-    _logger->Log("uc-online shutting down");
+template <typename Traits>
+UCOnlineLauncher<Traits>::~UCOnlineLauncher() {
+    _configWatcher.reset();
+    _logger->Info(Traits::kName, " shutting down");
     ShutdownUCOnline();
+    // Lets go of the game, it keeps running. One still suspended is closed
+    CloseGameProcess();
+    FinishStartupTrace();
+    _logger->Flush();
+    // A closed console window was only waiting for this
+    _exitEvents.ShutdownComplete();
+}
+
+template <typename Traits>
+void UCOnlineLauncher<Traits>::FinishStartupTrace() {
+    const LauncherSettings& settings = _resolved->GetSettings();
+    if (!settings.Get<ConfigKey::TraceStartup>()) {
+        return;
+    }
+
+    std::string tracePath = PathUtils::ResolveRelativeToExecutable(PathUtils::ToUtf8(settings.Get<ConfigKey::TraceFile>()));
+    if (!tracePath.empty() && _tracer.WriteChromeTrace(tracePath)) {
+        _logger->Info("Startup trace written to: ", tracePath);
+    }
+
+    // Kept apart per version and architecture, so the table compares like with like
+    std::vector<StartupTracer::PhaseStats> stats;
+    std::string statsPath = PathUtils::ResolveRelativeToExecutable(PathUtils::ToUtf8(settings.Get<ConfigKey::TraceStatsFile>()));
+    if (!statsPath.empty()) {
+        _tracer.UpdateStats(statsPath, std::string(UC_ONLINE_VERSION) + "/" + Traits::kName, stats);
+    }
+
+    std::string summary = _tracer.FormatSummary(stats);
+    std::cout << std::endl << "Startup timings (" << UC_ONLINE_VERSION << ", " << Traits::kArchitecture << "):" << std::endl << summary;
+    _logger->Info("Startup timings:\n", summary);
+}
+
+template <typename Traits>
+bool UCOnlineLauncher<Traits>::InitializeUCOnline() {
+    LogSourceScope source("InitializeUCOnline");
+    if (!StartSteam()) {
+        return false;
+    }
+
+    if (InitializeSteamInterfaces()) {
+        _logger->Info("Steam interfaces accessible");
+    } else {
+        _logger->Warning("Steam interfaces not accessible");
+    }
+    return true;
 }
 
-bool UCOnline::InitializeUCOnline() {
+template <typename Traits>
+bool UCOnlineLauncher<Traits>::StartSteam() {
+    LogSourceScope source("StartSteam");
     try {
         if (_currentAppID == 0) {
-            _logger->LogWarning("No appid set in the config.ini. This likely will not work.");
-            _logger->LogWarning("Please set appid in config.ini, if there is not one - there will be one after running this.");
-            _logger->LogWarning("Continuing without set appid.");
+            _logger->Warning("No appid set in the config.ini. This likely will not work.");
+            _logger->Warning("Please set appid in config.ini, if there is not one - there will be one after running this.");
+            _logger->Warning("Continuing without set appid.");
         } else {
-            _logger->Log("Initializing Steam with appid: " + std::to_string(_currentAppID));
+            _logger->Info("Initializing Steam with appid: ", _currentAppID);
             CreateAppIdFile();
         }
 
-        if (SteamAPI_RestartAppIfNecessary(_currentAppID)) {
-            _logger->Log("Steam requested app restart");
+        // steam_api isn't touched before this point, so nothing above pays for loading it
+        std::string loadError;
+        if (!_tracer.Time("LoadSteamApi", [&] { return _steam->Load(GetSteamApiLibraryPath(), loadError); })) {
+            _logger->Error("Could not load the Steam API: ", loadError);
+            std::cout << "Could not load the Steam API: " << loadError << std::endl;
             return false;
         }
 
-        SteamErrMsg errorMsg;
-        if (SteamAPI_InitEx(&errorMsg) != k_ESteamAPIInitResult_OK) {
-            _logger->Log("SteamAPI_InitEx failed: " + std::string(errorMsg));
+        if (_tracer.Time("SteamAPI_RestartAppIfNecessary", [&] { return _steam->RestartAppIfNecessary(_currentAppID); })) {
+            _logger->Info("Steam requested app restart");
             return false;
         }
 
-        _steamInitialized = true;
-        _logger->Log("Steam initialized successfully");
-
-        if (InitializeSteamInterfaces()) {
-            _logger->Log("Steam interfaces accessible");
-        } else {
-            _logger->LogWarning("Steam interfaces not accessible");
+        std::string errorMsg;
+        if (_tracer.Time("SteamAPI_InitEx", [&] { return _steam->Init(errorMsg); }) != SteamInitResult::OK) {
+            _logger->Error("SteamAPI_InitEx failed: ", errorMsg);
+            std::cout << "SteamAPI_InitEx failed: " << errorMsg << std::endl;
+            return false;
         }
 
+        _steamInitialized = true;
+        _logger->Info("Steam initialized successfully");
+        StartCallbackDispatch();
         return true;
     } catch (const std::exception& ex) {
+        _logger->LogException(ex, "Exception during Steam initialization");
         std::cout << "Exception during Steam initialization: " << ex.what() << std::endl;
         return false;
     }
 }
 
-void UCOnline::ShutdownUCOnline() {
+template <typename Traits>
+void UCOnlineLauncher<Traits>::ShutdownUCOnline() {
+    LogSourceScope source("ShutdownUCOnline");
+    // The pump and the background probes still talk to Steam, and log
+    StopCallbackPump();
+    _interfaces.Reset();
+    if (_callbackDispatch) {
+        auto stats = _callbackDispatch->dispatcher.GetStats();
+        _logger->Info("Manual dispatch handled ", stats.callbacks, " callbacks and ", stats.callResults, " call results, ",
+                      stats.unhandled, " unhandled, ", stats.dropped, " dropped");
+        _callbackDispatch.reset();
+    }
     if (_steamInitialized) {
-        _logger->Log("Shutting down...");
-        SteamAPI_Shutdown();
+        _logger->Info("Shutting down...");
+        _tracer.Time("SteamAPI_Shutdown", [&] { _steam->Shutdown(); });
         _steamInitialized = false;
-        _logger->Log("Shutdown complete!");
+        _logger->Info("Shutdown complete");
     }
 }
 
-void UCOnline::RunSteamCallbacks() {
-    if (_steamInitialized) {
-        SteamAPI_RunCallbacks();
+template <typename Traits>
+void UCOnlineLauncher<Traits>::StartCallbackDispatch() {
+    if (!_resolved->GetSettings().Get<ConfigKey::ManualCallbackDispatch>()) {
+        return;
+    }
+    if (!_steam->InitManualDispatch()) {
+        _logger->Warning("This steam_api can't dispatch callbacks manually, using SteamAPI_RunCallbacks");
+        return;
+    }
+    _callbackDispatch = std::make_unique<CallbackDispatch>(*_steam, *this);
+    _logger->Info("Dispatching Steam callbacks manually");
+}
+
+template <typename Traits>
+uint32_t UCOnlineLauncher<Traits>::RunCallbackFrame() {
+    uint32_t delivered = _callbackDispatch ? _callbackDispatch->dispatcher.RunFrame() : _steam->RunCallbacks();
+    // Between lines the interval flush happens here and in WaitForExit()
+    _logger->FlushIfDue();
+    return delivered;
+}
+
+template <typename Traits>
+bool UCOnlineLauncher<Traits>::StartCallbackPump() {
+    if (!_steamInitialized) {
+        return false;
+    }
+    if (_callbackPump) {
+        return true;
+    }
+
+    const LauncherSettings& settings = _resolved->GetSettings();
+    CallbackPumpOptions options;
+    options.frequencyHz = settings.Get<ConfigKey::CallbackRateHz>();
+    options.maxIdleIntervalMs = settings.Get<ConfigKey::CallbackIdleMaxMs>();
+    // SteamAPI_RunCallbacks never says how many it ran, every frame would look idle
+    bool counted = _callbackDispatch || _steam->CountsCallbacks();
+    if (!counted) {
+        options.maxIdleIntervalMs = 0;
+    }
+    _callbackPump = std::make_unique<CallbackPump>([this]() { return RunCallbackFrame(); }, options);
+    _callbackPump->Start();
+    if (counted) {
+        _logger->Info("Running Steam callbacks at ", options.frequencyHz, " Hz, backing off to every ", options.maxIdleIntervalMs, " ms when idle");
+    } else {
+        _logger->Info("Running Steam callbacks at ", options.frequencyHz, " Hz (no idle backoff without ManualCallbackDispatch)");
+    }
+    return true;
+}
+
+template <typename Traits>
+void UCOnlineLauncher<Traits>::StopCallbackPump() {
+    if (!_callbackPump) {
+        return;
+    }
+    _callbackPump->Stop();
+    CallbackPump::Stats stats = _callbackPump->GetStats();
+    _logger->Info("Callback pump stopped after ", stats.frames, " frames, ", stats.callbacks, " callbacks, ",
+                  std::chrono::duration_cast<std::chrono::microseconds>(stats.dispatchTime).count() / 1000.0, " ms dispatching");
+    _callbackPump.reset();
+}
+
+template <typename Traits>
+void UCOnlineLauncher<Traits>::WakeCallbackPump() {
+    if (_callbackPump) {
+        _callbackPump->Wake();
+    }
+}
+
+template <typename Traits>
+CallbackPump::Stats UCOnlineLauncher<Traits>::GetCallbackPumpStats() const {
+    return _callbackPump ? _callbackPump->GetStats() : CallbackPump::Stats();
+}
+
+template <typename Traits>
+ExitReason UCOnlineLauncher<Traits>::WaitForExit(std::chrono::milliseconds timeout) {
+    if (!_exitEvents.ListenForSignals()) {
+        _logger->Warning("Could not listen for Ctrl+C, closing the window is the only way out early");
+    }
+    if (_game.id != 0 && !_exitEvents.WatchProcess(_game.id)) {
+        _logger->Warning("Could not watch the game process, waiting for the timeout instead");
+    }
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    // The log's interval flush can't count on the callback pump, it might not be running
+    // (no Steam) or be idling, so this thread wakes up for it as well
+    std::chrono::milliseconds flushInterval = _logger->GetFlushInterval();
+    ExitReason reason = ExitReason::None;
+    for (;;) {
+        std::chrono::milliseconds wait(0);
+        if (timeout.count() > 0) {
+            auto left = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            wait = std::max(left, std::chrono::milliseconds(1));
+        }
+        if (flushInterval.count() > 0 && (wait.count() == 0 || flushInterval < wait)) {
+            reason = _exitEvents.WaitAtMost(flushInterval);
+        } else {
+            reason = _exitEvents.Wait(wait);
+        }
+        if (reason != ExitReason::None) {
+            break;
+        }
+        // Woken (the config watcher may have a new snapshot) or time for a flush
+        ApplyConfigChanges();
+        _logger->FlushIfDue();
     }
+    _logger->Info("Done waiting: ", ExitReasonName(reason));
+    return reason;
 }
 
-void UCOnline::SetCustomAppID(uint32_t appID) {
+template <typename Traits>
+void UCOnlineLauncher<Traits>::RequestExit() {
+    _exitEvents.Notify(ExitReason::Requested);
+}
+
+template <typename Traits>
+void UCOnlineLauncher<Traits>::SetCustomAppID(uint32_t appID) {
     _currentAppID = appID;
-    _config->SetAppID(appID);
-    _config->SaveConfig();
-    _logger->Log("Appid changed to: " + std::to_string(appID));
+    {
+        ConfigTransaction transaction(*_config);
+        _config->SetAppID(appID);
+    }
+    _logger->Info("Appid changed to: ", appID);
 
     if (_steamInitialized) {
-        _logger->Log("Reinitializing Steam with new appid");
+        _logger->Info("Reinitializing Steam with new appid");
         ShutdownUCOnline();
         InitializeUCOnline();
     }
 }
 
-uint32_t UCOnline::GetCurrentAppID() const {
+template <typename Traits>
+uint32_t UCOnlineLauncher<Traits>::GetCurrentAppID() const {
     return _currentAppID;
 }
 
-bool UCOnline::IsSteamInitialized() const {
+template <typename Traits>
+bool UCOnlineLauncher<Traits>::IsSteamInitialized() const {
     return _steamInitialized;
 }
 
-void UCOnline::CreateAppIdFile() {
+template <typename Traits>
+void UCOnlineLauncher<Traits>::CreateAppIdFile() {
+    LogSourceScope source("CreateAppIdFile");
+    TraceSpan span(_tracer, "CreateAppIdFile");
     if (_currentAppID == 0) {
-        _logger->Log("Skipping steam_appid.txt creation - no appid configured.");
-        _logger->Log("If there is one already, it will be ignored.");
+        _logger->Info("Skipping steam_appid.txt creation - no appid configured.");
+        _logger->Info("If there is one already, it will be ignored.");
         return;
     }
 
     try {
         std::string appIdFilePath = PathUtils::ResolveRelativeToExecutable("steam_appid.txt");
-        std::ofstream file(appIdFilePath);
+        std::ofstream file(PathUtils::ToPath(appIdFilePath));
         if (file.is_open()) {
             file << _currentAppID;
-            _logger->Log("Created steam_appid.txt at: " + appIdFilePath + " with appid: " + std::to_string(_currentAppID));
+            _logger->Info("Created steam_appid.txt at: ", appIdFilePath, " with appid: ", _currentAppID);
         } else {
             std::cerr << "Failed to create steam_appid.txt at: " << appIdFilePath << std::endl;
         }
@@ -122,222 +434,476 @@ void UCOnline::CreateAppIdFile() {
     }
 }
 
+template <typename Traits>
+bool UCOnlineLauncher<Traits>::InitializeSteamInterfaces() {
+    LogSourceScope source("InitializeSteamInterfaces");
+    // Only the required ones here, the rest wait until the game is running (see LaunchGame)
+    return _interfaces.ProbeRequired();
+}
 
+template <typename Traits>
+void UCOnlineLauncher<Traits>::LogInterfaceProbe(SteamInterface which, InterfaceUse use, bool available) {
+    // Can be the probe thread, the logger doesn't mind
+    if (available) {
+        _logger->Info("Successfully obtained ", SteamInterfaceName(which), " interface");
+    } else if (use == InterfaceUse::Required) {
+        _logger->Error(SteamInterfaceName(which), " interface not available");
+    } else {
+        _logger->Warning(SteamInterfaceName(which), " interface not available");
+    }
+}
 
-bool UCOnline::InitializeSteamInterfaces() {
-    try {
-        if (!SteamUser()) {
-            _logger->LogError("SteamUser interface not available");
-            return false;
-        }
-
-        if (!SteamApps()) {
-            _logger->LogWarning("SteamApps interface not available");
-        } else {
-            _logger->Log("Successfully obtained SteamApps interface");
-        }
-
-        // Initialize all Steam interfaces
-        if (!InitializeSteamGameServer()) {
-            _logger->LogWarning("Failed to initialize Steam GameServer interface");
-        }
-
-        if (!InitializeSteamUGC()) {
-            _logger->LogWarning("Failed to initialize Steam UGC interface");
-        }
-
-        if (!InitializeSteamHTTP()) {
-            _logger->LogWarning("Failed to initialize Steam HTTP interface");
-        }
+template <typename Traits>
+bool UCOnlineLauncher<Traits>::HasSteamInterface(SteamInterface which) {
+    return _steamInitialized && _interfaces.IsAvailable(which);
+}
 
-        if (!InitializeSteamNetworking()) {
-            _logger->LogWarning("Failed to initialize Steam Networking interface");
-        }
+template <typename Traits>
+std::bitset<static_cast<size_t>(SteamInterface::Count)> UCOnlineLauncher<Traits>::GetAvailableSteamInterfaces() const {
+    return _interfaces.GetAvailable();
+}
 
-        if (!InitializeSteamClient()) {
-            _logger->LogWarning("Failed to initialize Steam Client interface");
-        }
+template <typename Traits>
+bool UCOnlineLauncher<Traits>::CheckGameExecutable() {
+    if (_gameExecutable.empty()) {
+        _logger->Error("No game executable configured in config.ini file. You'll need to do that to get anywhere here.");
+        std::cout << "No game executable configured in config.ini file. (I suggest you set it lol)" << std::endl;
+        return false;
+    }
 
-        return true;
-    } catch (const std::exception& ex) {
-        _logger->LogException(ex, "Error initializing Steam interfaces");
+    if (!std::filesystem::exists(PathUtils::ToPath(_gameExecutable))) {
+        _logger->Error("Game executable not found (Did you write it correctly? Path and all too, if applicable.): ", _gameExecutable);
+        std::cout << "Game executable not found (Did you write it correctly? Path and all too, if applicable.): " << _gameExecutable << std::endl;
         return false;
     }
+    return true;
 }
 
-bool UCOnline::InitializeSteamGameServer() {
-    try {
-        if (!SteamGameServer()) {
-            _logger->LogError("SteamGameServer interface not available");
-            return false;
-        }
-        _logger->Log("Successfully obtained SteamGameServer interface");
-        return true;
-    } catch (const std::exception& ex) {
-        _logger->LogException(ex, "Error initializing Steam GameServer interface");
+template <typename Traits>
+bool UCOnlineLauncher<Traits>::LaunchGame() {
+    LogSourceScope source("LaunchGame");
+    _logger->Info("Attempting to launch game: ", _gameExecutable);
+    if (!CheckGameExecutable()) {
         return false;
     }
-}
 
-bool UCOnline::InitializeSteamUGC() {
     try {
-        if (!SteamUGC()) {
-            _logger->LogError("SteamUGC interface not available");
+        _logger->Info("Launching game: ", _gameExecutable, " ", _gameArguments);
+        std::cout << "Launching game: " << _gameExecutable << " " << _gameArguments << std::endl;
+
+        if (_tracer.Time("CreateProcess", [&] { return StartGameProcess(false); })) {
+            OnGameStarted();
+            return true;
+        } else {
+            _logger->Error("Failed to launch game process");
+            std::cout << "Failed to launch game process" << std::endl;
             return false;
         }
-        _logger->Log("Successfully obtained SteamUGC interface");
-        return true;
     } catch (const std::exception& ex) {
-        _logger->LogException(ex, "Error initializing Steam UGC interface");
+        _logger->LogException(ex, "Game launch failed");
+        _logger->Info("This can happen for many reasons, if you're certain it should work then just try whatever you can. Throw whatever you got at the wall and see what sticks.");
+        std::cout << "Error launching game: " << ex.what() << std::endl;
         return false;
     }
 }
 
-bool UCOnline::InitializeSteamHTTP() {
-    try {
-        if (!SteamHTTP()) {
-            _logger->LogError("SteamHTTP interface not available");
-            return false;
-        }
-        _logger->Log("Successfully obtained SteamHTTP interface");
-        return true;
-    } catch (const std::exception& ex) {
-        _logger->LogException(ex, "Error initializing Steam HTTP interface");
+template <typename Traits>
+bool UCOnlineLauncher<Traits>::LaunchGamePipelined() {
+    LogSourceScope source("LaunchGamePipelined");
+    _logger->Info("Attempting to launch game alongside Steam: ", _gameExecutable);
+    if (!CheckGameExecutable()) {
         return false;
     }
-}
 
-bool UCOnline::InitializeSteamNetworking() {
+    // The game gets a copy of our environment when it's created, before Steam is up to set these
+    ExportSteamEnvironment();
+
+    // Steam starts on its own thread while the game process is set up here. StartSteam catches everything itself
+    std::future<bool> steam = std::async(std::launch::async, [this]() { return StartSteam(); });
+
+    bool created = false;
     try {
-        if (!SteamNetworking()) {
-            _logger->LogError("SteamNetworking interface not available");
-            return false;
-        }
-        _logger->Log("Successfully obtained SteamNetworking interface");
-        return true;
+        _logger->Info("Launching game suspended: ", _gameExecutable, " ", _gameArguments);
+        std::cout << "Launching game: " << _gameExecutable << " " << _gameArguments << std::endl;
+        created = _tracer.Time("CreateProcess", [&] { return StartGameProcess(true); });
     } catch (const std::exception& ex) {
-        _logger->LogException(ex, "Error initializing Steam Networking interface");
+        _logger->LogException(ex, "Game launch failed");
+    }
+    bool steamStarted = steam.get();
+
+    if (!created) {
+        _logger->Error("Failed to launch game process");
+        std::cout << "Failed to launch game process" << std::endl;
+        return false;
+    }
+    if (!steamStarted) {
+        _logger->Error("Steam did not start, closing the suspended game again");
+        TerminateGameProcess();
         return false;
     }
+    if (!_tracer.Time("ResumeProcess", [&] { return ResumeGameProcess(); })) {
+        _logger->Error("Could not resume the game process");
+        std::cout << "Failed to launch game process" << std::endl;
+        TerminateGameProcess();
+        return false;
+    }
+    OnGameStarted();
+
+    if (InitializeSteamInterfaces()) {
+        _logger->Info("Steam interfaces accessible");
+    } else {
+        _logger->Warning("Steam interfaces not accessible");
+    }
+    return true;
 }
 
-bool UCOnline::InitializeSteamClient() {
-    try {
-        if (!SteamClient()) {
-            _logger->LogError("SteamClient interface not available");
-            return false;
-        }
-        _logger->Log("Successfully obtained SteamClient interface");
-        return true;
-    } catch (const std::exception& ex) {
-        _logger->LogException(ex, "Error initializing Steam Client interface");
-        return false;
+template <typename Traits>
+void UCOnlineLauncher<Traits>::OnGameStarted() {
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(StartupTracer::Clock::now() - _tracer.GetOrigin());
+    _tracer.Record("TimeToGame", _tracer.GetOrigin(), StartupTracer::Clock::now());
+    _logger->Info("Game launched successfully! (PID: ", _game.id, ", ", elapsed.count() / 1000.0, " ms after the launcher started)");
+    // Nothing waits on these, so they're only looked at now the game is on its way
+    if (_steamInitialized) {
+        _interfaces.ProbeOptionalAsync();
     }
+    std::cout << "Game launched successfully! The game's window should appear shortly. This window can be closed and / or may close on its own." << std::endl;
 }
 
-bool UCOnline::LaunchGame() {
-    _logger->Log("Attempting to launch game: " + _gameExecutable);
+template <typename Traits>
+void UCOnlineLauncher<Traits>::ExportSteamEnvironment() {
+    if (_currentAppID == 0) {
+        return;
+    }
+    std::string appId = std::to_string(_currentAppID);
+#ifdef _WIN32
+    std::wstring value(appId.begin(), appId.end());
+    SetEnvironmentVariableW(L"SteamAppId", value.c_str());
+    SetEnvironmentVariableW(L"SteamGameId", value.c_str());
+#else
+    setenv("SteamAppId", appId.c_str(), 1);
+    setenv("SteamGameId", appId.c_str(), 1);
+#endif
+}
 
-    if (_gameExecutable.empty()) {
-        _logger->LogError("No game executable configured in config.ini file. You'll need to do that to get anywhere here.");
-        std::cout << "No game executable configured in config.ini file. (I suggest you set it lol)" << std::endl;
+#ifdef _WIN32
+template <typename Traits>
+bool UCOnlineLauncher<Traits>::StartGameProcess(bool suspended) {
+    CloseGameProcess();
+
+    // Wide API so a game under a non-ASCII path still starts
+    std::filesystem::path exePath = PathUtils::ToPath(_gameExecutable);
+    std::wstring workingDir = exePath.parent_path().wstring();
+
+    STARTUPINFOW si = { sizeof(si) };
+    PROCESS_INFORMATION pi;
+
+    std::wstring commandLine = L"\"" + exePath.wstring() + L"\" " + PathUtils::ToPath(_gameArguments).wstring();
+
+    if (!CreateProcessW(NULL, &commandLine[0], NULL, NULL, FALSE, suspended ? CREATE_SUSPENDED : 0, NULL, workingDir.c_str(), &si, &pi)) {
         return false;
     }
+    _game.id = pi.dwProcessId;
+    _game.process = pi.hProcess;
+    if (suspended) {
+        _game.thread = pi.hThread;
+    } else {
+        CloseHandle(pi.hThread);
+    }
+    return true;
+}
 
-    if (!std::filesystem::exists(_gameExecutable)) {
-        _logger->LogError("Game executable not found (Did you write it correctly? Path and all too, if applicable.): " + _gameExecutable);
-        std::cout << "Game executable not found (Did you write it correctly? Path and all too, if applicable.): " << _gameExecutable << std::endl;
+template <typename Traits>
+bool UCOnlineLauncher<Traits>::ResumeGameProcess() {
+    if (!_game.thread) {
         return false;
     }
+    bool resumed = ResumeThread(static_cast<HANDLE>(_game.thread)) != static_cast<DWORD>(-1);
+    CloseHandle(static_cast<HANDLE>(_game.thread));
+    _game.thread = nullptr;
+    return resumed;
+}
 
-    try {
-        _logger->Log("Launching game: " + _gameExecutable + " " + _gameArguments);
-        std::cout << "Launching game: " << _gameExecutable << " " << _gameArguments << std::endl;
+template <typename Traits>
+void UCOnlineLauncher<Traits>::TerminateGameProcess() {
+    if (_game.process) {
+        TerminateProcess(static_cast<HANDLE>(_game.process), 1);
+    }
+    CloseGameProcess();
+}
 
-        std::filesystem::path exePath(_gameExecutable);
-        std::string workingDir = exePath.parent_path().string();
+template <typename Traits>
+void UCOnlineLauncher<Traits>::CloseGameProcess() {
+    if (_game.thread) {
+        CloseHandle(static_cast<HANDLE>(_game.thread));
+    }
+    if (_game.process) {
+        CloseHandle(static_cast<HANDLE>(_game.process));
+    }
+    _game = GameProcess();
+}
+#else
+namespace {
+    // Splits GameArguments the way a shell would split plain words: whitespace separates,
+    // '...' is taken literally, "..." and a backslash only protect the next character(s).
+    // Nothing gets expanded, the game is exec'd directly and never sees a shell
+    std::vector<std::string> SplitArguments(const std::string& text) {
+        std::vector<std::string> arguments;
+        std::string current;
+        bool inWord = false;
+        char quote = 0;
+        for (size_t i = 0; i < text.size(); i++) {
+            char c = text[i];
+            if (quote == '\'') {
+                if (c == '\'') quote = 0;
+                else current.push_back(c);
+            } else if (c == '\\' && i + 1 < text.size() && (quote == 0 || std::strchr("\"\\$`", text[i + 1]))) {
+                current.push_back(text[++i]);
+                inWord = true;
+            } else if (quote == '"') {
+                if (c == '"') quote = 0;
+                else current.push_back(c);
+            } else if (c == '\'' || c == '"') {
+                quote = c;
+                inWord = true;
+            } else if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+                if (inWord) arguments.push_back(std::move(current));
+                current.clear();
+                inWord = false;
+            } else {
+                current.push_back(c);
+                inWord = true;
+            }
+        }
+        if (inWord) arguments.push_back(std::move(current));
+        return arguments;
+    }
+}
 
-        STARTUPINFOA si = { sizeof(si) };
-        PROCESS_INFORMATION pi;
+template <typename Traits>
+bool UCOnlineLauncher<Traits>::StartGameProcess(bool suspended) {
+    CloseGameProcess();
 
-        std::string commandLine = "\"" + _gameExecutable + "\" " + _gameArguments;
+    // Everything the child needs is built here. A StartSteam thread may be running while we
+    // fork, so the child only gets to call async-signal-safe functions (read, chdir, execv, _exit)
+    std::error_code ec;
+    std::filesystem::path exePath = std::filesystem::absolute(PathUtils::ToPath(_gameExecutable), ec);
+    if (ec) {
+        return false;
+    }
+    std::string executable = PathUtils::ToUtf8(exePath);
+    std::string workingDir = PathUtils::ToUtf8(exePath.parent_path());
+    std::vector<std::string> arguments = SplitArguments(_gameArguments);
+    std::vector<char*> argv;
+    argv.reserve(arguments.size() + 2);
+    argv.push_back(&executable[0]);
+    for (std::string& argument : arguments) {
+        argv.push_back(&argument[0]);
+    }
+    argv.push_back(nullptr);
 
-        if (CreateProcessA(NULL, const_cast<char*>(commandLine.c_str()), NULL, NULL, FALSE, 0, NULL, workingDir.c_str(), &si, &pi)) {
-            _logger->Log("Game launched successfully! (PID: " + std::to_string(pi.dwProcessId) + ")");
-            std::cout << "Game launched successfully! The game's window should appear shortly. This window can be closed and / or may close on its own." << std::endl;
-            CloseHandle(pi.hProcess);
-            CloseHandle(pi.hThread);
-            return true;
-        } else {
-            _logger->LogError("Failed to launch game process");
-            std::cout << "Failed to launch game process" << std::endl;
+    // A suspended child blocks on this pipe before exec: a byte means go, end of file means give up.
+    // Close-on-exec, so the game itself never sees it
+    int gate[2] = { -1, -1 };
+    if (suspended) {
+        if (pipe(gate) != 0) {
             return false;
         }
-    } catch (const std::exception& ex) {
-        _logger->LogException(ex, "Game launch failed");
-        _logger->Log("This can happen for many reasons, if you're certain it should work then just try whatever you can. Throw whatever you got at the wall and see what sticks.");
-        std::cout << "Error launching game: " << ex.what() << std::endl;
+        fcntl(gate[0], F_SETFD, FD_CLOEXEC);
+        fcntl(gate[1], F_SETFD, FD_CLOEXEC);
+    }
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        if (suspended) {
+            close(gate[0]);
+            close(gate[1]);
+        }
         return false;
     }
+    if (pid == 0) {
+        if (suspended) {
+            close(gate[1]);
+            char go = 0;
+            ssize_t got;
+            do {
+                got = read(gate[0], &go, 1);
+            } while (got < 0 && errno == EINTR);
+            if (got != 1) {
+                _exit(127);
+            }
+        }
+        if (!workingDir.empty() && chdir(workingDir.c_str()) != 0) {
+            _exit(127);
+        }
+        execv(argv[0], argv.data());
+        _exit(127);
+    }
+    if (suspended) {
+        close(gate[0]);
+        _game.gate = gate[1];
+    }
+    _game.id = static_cast<uint32_t>(pid);
+    return true;
 }
 
-void UCOnline::SetGameExecutable(const std::string& gameExePath) {
+template <typename Traits>
+bool UCOnlineLauncher<Traits>::ResumeGameProcess() {
+    if (_game.gate < 0) {
+        return false;
+    }
+    char go = 1;
+    bool resumed = write(_game.gate, &go, 1) == 1;
+    close(_game.gate);
+    _game.gate = -1;
+    return resumed;
+}
+
+template <typename Traits>
+void UCOnlineLauncher<Traits>::TerminateGameProcess() {
+    if (_game.id == 0) {
+        return;
+    }
+    pid_t pid = static_cast<pid_t>(_game.id);
+    if (_game.gate >= 0) {
+        // Still waiting at the gate, closing it makes the child exit without ever running the game
+        close(_game.gate);
+        _game.gate = -1;
+    } else {
+        kill(pid, SIGTERM);
+    }
+    waitpid(pid, nullptr, 0);
+    _game = GameProcess();
+}
+
+template <typename Traits>
+void UCOnlineLauncher<Traits>::CloseGameProcess() {
+    if (_game.gate >= 0) {
+        close(_game.gate);
+    }
+    _game = GameProcess();
+}
+#endif
+
+template <typename Traits>
+void UCOnlineLauncher<Traits>::SetGameExecutable(const std::string& gameExePath) {
     _gameExecutable = gameExePath;
+    ConfigTransaction transaction(*_config);
     _config->SetGameExecutable(gameExePath);
-    _config->SaveConfig();
 }
 
-void UCOnline::SetGameArguments(const std::string& arguments) {
+template <typename Traits>
+void UCOnlineLauncher<Traits>::SetGameArguments(const std::string& arguments) {
     _gameArguments = arguments;
+    ConfigTransaction transaction(*_config);
     _config->SetGameArguments(arguments);
-    _config->SaveConfig();
 }
 
-std::string UCOnline::GetGameExecutable() const {
+template <typename Traits>
+std::string UCOnlineLauncher<Traits>::GetGameExecutable() const {
     return _gameExecutable;
 }
 
-std::string UCOnline::GetGameArguments() const {
+template <typename Traits>
+std::string UCOnlineLauncher<Traits>::GetGameArguments() const {
     return _gameArguments;
 }
 
-void UCOnline::SaveConfig() {
-    _config->SetAppID(_currentAppID);
-    _config->SetGameExecutable(_gameExecutable);
-    _config->SetGameArguments(_gameArguments);
-    _config->SaveConfig();
+template <typename Traits>
+void UCOnlineLauncher<Traits>::SaveConfig() {
+    // Values from the environment or command line are for this run only, don't bake them into config.ini
+    ConfigTransaction transaction(*_config);
+    if (!_resolved->IsOverridden(ConfigKey::AppID)) {
+        _config->SetAppID(_currentAppID);
+    }
+    if (!_resolved->IsOverridden(ConfigKey::GameExecutable)) {
+        _config->SetGameExecutable(_gameExecutable);
+    }
+    if (!_resolved->IsOverridden(ConfigKey::GameArguments)) {
+        _config->SetGameArguments(_gameArguments);
+    }
 }
 
-void UCOnline::ReloadConfig() {
+template <typename Traits>
+void UCOnlineLauncher<Traits>::ReloadConfig() {
     _config->LoadConfig();
-    _currentAppID = _config->GetAppID();
-    _gameExecutable = _config->GetGameExecutable();
-    _gameArguments = _config->GetGameArguments();
+    ResolveConfig();
+    ApplyResolvedConfig();
 }
 
-Logger* UCOnline::GetLogger() {
+template <typename Traits>
+void UCOnlineLauncher<Traits>::ApplyResolvedConfig() {
+    const LauncherSettings& settings = _resolved->GetSettings();
+    _currentAppID = settings.Get<ConfigKey::AppID>();
+    _gameExecutable = PathUtils::ToUtf8(settings.Get<ConfigKey::GameExecutable>());
+    _gameArguments = settings.Get<ConfigKey::GameArguments>();
+}
+
+template <typename Traits>
+bool UCOnlineLauncher<Traits>::ApplyConfigChanges() {
+    if (!_configWatcher) return false;
+    // Version first: it goes up after the snapshot is stored, so the snapshot is at least that new
+    uint64_t version = _configWatcher->GetVersion();
+    if (version == _appliedConfigVersion) return false;
+    _appliedConfigVersion = version;
+
+    uint32_t previousAppID = _currentAppID;
+    // _config itself stays as it was loaded, SaveConfig() merges with what's on disk anyway
+    std::shared_ptr<const IniConfig> snapshot = _configWatcher->GetSnapshot();
+    _resolved = std::make_shared<const LayeredConfig>(_machineConfig.get(), *snapshot, _environment, _commandLine);
+    ApplyResolvedConfig();
+    if (_currentAppID != previousAppID) {
+        _logger->Info("Appid changed to ", _currentAppID, ", it will be used from the next launch");
+    }
+    return true;
+}
+
+template <typename Traits>
+ConfigTransaction UCOnlineLauncher<Traits>::BeginConfigTransaction() {
+    return ConfigTransaction(*_config);
+}
+
+template <typename Traits>
+const LayeredConfig& UCOnlineLauncher<Traits>::GetResolvedConfig() const {
+    return *_resolved;
+}
+
+template <typename Traits>
+const StartupTracer& UCOnlineLauncher<Traits>::GetStartupTracer() const {
+    return _tracer;
+}
+
+template <typename Traits>
+Logger* UCOnlineLauncher<Traits>::GetLogger() {
     return _logger.get();
 }
 
-void UCOnline::SetLoggingEnabled(bool enabled) {
+template <typename Traits>
+void UCOnlineLauncher<Traits>::SetLoggingEnabled(bool enabled) {
     _logger->SetLoggingEnabled(enabled);
-    _logger->Log("Logging " + std::string(enabled ? "enabled" : "disabled"));
+    _logger->Info("Logging ", enabled ? "enabled" : "disabled");
 }
 
-bool UCOnline::IsLoggingEnabled() const {
+template <typename Traits>
+bool UCOnlineLauncher<Traits>::IsLoggingEnabled() const {
     return _logger->IsLoggingEnabledA();
 }
 
-void UCOnline::ClearLog() {
+template <typename Traits>
+void UCOnlineLauncher<Traits>::ClearLog() {
     _logger->ClearLog();
 }
 
-std::string UCOnline::GetSteamApiDllPath() const {
+template <typename Traits>
+std::string UCOnlineLauncher<Traits>::GetSteamApiDllPath() const {
     return _steamApiDllPath;
 }
 
-void UCOnline::SetSteamApiDllPath(const std::string& dllPath) {
+template <typename Traits>
+void UCOnlineLauncher<Traits>::SetSteamApiDllPath(const std::string& dllPath) {
     _steamApiDllPath = dllPath;
+    ConfigTransaction transaction(*_config);
     _config->SetSteamApiDllPath(dllPath);
-    _config->SaveConfig();
-}
\ No newline at end of file
+}
+
+template class UCOnlineLauncher<Launcher32Traits>;
+template class UCOnlineLauncher<Launcher64Traits>;
@@ -0,0 +1,309 @@
+// Runs UCOnlineLauncher<Launcher64Traits> against MockSteamBackend scripts: how init
+// failures, restart requests, missing interfaces, a scripted callback stream and the
+// machine config layer come out, plus how config.ini saves look and when the log flushes.
+// No Steam client needed. Every test gets a config.ini of its own in a temp directory.
+// Usage: launcher-tests [test...]          no names = all of them
+#include "uc_online.hpp"
+#include "mock_steam_backend.hpp"
+#include <steam/isteamuser.h>
+#include <steam/isteamutils.h>
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    int g_failures = 0;
+
+    void Check(bool condition, const char* what, int line) {
+        if (!condition) {
+            std::cerr << "  line " << line << ": " << what << std::endl;
+            g_failures++;
+        }
+    }
+
+#define CHECK(condition) Check((condition), #condition, __LINE__)
+
+    // A config.ini that keeps the launcher quiet: no watcher thread, no log file
+    std::string WriteConfig(const std::string& name, const std::string& extra = "") {
+        std::filesystem::path dir = std::filesystem::temp_directory_path() / "uc-online-tests" / name;
+        std::filesystem::create_directories(dir);
+        std::filesystem::path path = dir / "config.ini";
+        std::ofstream(path, std::ios::binary | std::ios::trunc)
+            << "[uc-online]\n"
+            << "AppID = 480\n"
+            << "WatchConfig = false\n"
+            << extra
+            << "[Logging]\n"
+            << "EnableLogging = false\n";
+        return PathUtils::ToUtf8(path);
+    }
+
+    void SetEnvironment(const char* name, const std::string& value) {
+#ifdef _WIN32
+        _putenv_s(name, value.c_str());
+#else
+        if (value.empty()) {
+            unsetenv(name);
+        } else {
+            setenv(name, value.c_str(), 1);
+        }
+#endif
+    }
+
+    template <typename Callback>
+    std::vector<uint8_t> Payload() {
+        return std::vector<uint8_t>(sizeof(Callback));
+    }
+
+    void InitFailure() {
+        MockSteamBackend::Script script;
+        script.initResult = SteamInitResult::NoSteamClient;
+        script.initError = "no client";
+        auto mock = std::make_shared<MockSteamBackend>(script);
+        UCOnline64 launcher(mock, WriteConfig("init-failure"));
+
+        CHECK(!launcher.InitializeUCOnline());
+        CHECK(!launcher.IsSteamInitialized());
+        CHECK(!launcher.StartCallbackPump());
+        MockSteamBackend::Counters counters = mock->GetCounters();
+        CHECK(counters.initCalls == 1);
+        CHECK(counters.probeCalls == 0);
+        launcher.ShutdownUCOnline();
+        CHECK(mock->GetCounters().shutdownCalls == 0);
+    }
+
+    void RestartRequired() {
+        MockSteamBackend::Script script;
+        script.restartRequired = true;
+        auto mock = std::make_shared<MockSteamBackend>(script);
+        UCOnline64 launcher(mock, WriteConfig("restart-required"));
+
+        CHECK(!launcher.InitializeUCOnline());
+        CHECK(!launcher.IsSteamInitialized());
+        MockSteamBackend::Counters counters = mock->GetCounters();
+        CHECK(counters.restartCalls == 1);
+        // Steam starts the game itself then, nothing gets initialized here
+        CHECK(counters.initCalls == 0);
+    }
+
+    void MissingRequiredInterface() {
+        MockSteamBackend::Script script;
+        script.missingInterfaces.set(static_cast<size_t>(SteamInterface::User));
+        auto mock = std::make_shared<MockSteamBackend>(script);
+        UCOnline64 launcher(mock, WriteConfig("missing-required"));
+
+        // Still up, the launcher only complains about it
+        CHECK(launcher.InitializeUCOnline());
+        CHECK(launcher.IsSteamInitialized());
+        CHECK(!launcher.GetAvailableSteamInterfaces().test(static_cast<size_t>(SteamInterface::User)));
+        CHECK(!launcher.HasSteamInterface(SteamInterface::User));
+        // Only the required one is probed during init
+        CHECK(mock->GetCounters().probeCalls == 1);
+        CHECK(launcher.HasSteamInterface(SteamInterface::Apps));
+    }
+
+    void MissingOptionalInterface() {
+        MockSteamBackend::Script script;
+        script.missingInterfaces.set(static_cast<size_t>(SteamInterface::HTTP));
+        auto mock = std::make_shared<MockSteamBackend>(script);
+        UCOnline64 launcher(mock, WriteConfig("missing-optional"));
+
+        CHECK(launcher.InitializeUCOnline());
+        CHECK(launcher.GetAvailableSteamInterfaces().test(static_cast<size_t>(SteamInterface::User)));
+        // Not looked at before someone asks
+        CHECK(mock->GetCounters().probeCalls == 1);
+        CHECK(!launcher.GetAvailableSteamInterfaces().test(static_cast<size_t>(SteamInterface::HTTP)));
+        CHECK(!launcher.HasSteamInterface(SteamInterface::HTTP));
+        CHECK(mock->GetCounters().probeCalls == 2);
+        // The answer is remembered
+        CHECK(!launcher.HasSteamInterface(SteamInterface::HTTP));
+        CHECK(mock->GetCounters().probeCalls == 2);
+    }
+
+    void CallbackStreamEndsInShutdown() {
+        auto mock = std::make_shared<MockSteamBackend>();
+        UCOnline64 launcher(mock, WriteConfig("callback-stream", "ManualCallbackDispatch = true\nCallbackRateHz = 100\n"));
+        CHECK(launcher.InitializeUCOnline());
+
+        mock->QueueCallback(SteamServersConnected_t::k_iCallback, Payload<SteamServersConnected_t>());
+        mock->QueueCallback(SteamServerConnectFailure_t::k_iCallback, Payload<SteamServerConnectFailure_t>(), 1);
+        // Wrong size, dropped instead of reaching the handler
+        mock->QueueCallback(SteamShutdown_t::k_iCallback, {}, 1);
+        mock->QueueCallback(SteamServersDisconnected_t::k_iCallback, Payload<SteamServersDisconnected_t>(), 2);
+        mock->QueueCallback(SteamShutdown_t::k_iCallback, Payload<SteamShutdown_t>(), 3);
+
+        CHECK(launcher.StartCallbackPump());
+        ExitReason reason = launcher.WaitForExit(std::chrono::seconds(10));
+        CHECK(reason == ExitReason::Requested);
+        // Whatever ended it first stays the answer
+        CHECK(launcher.WaitForExit(std::chrono::milliseconds(10)) == ExitReason::Requested);
+        launcher.StopCallbackPump();
+
+        MockSteamBackend::Counters counters = mock->GetCounters();
+        CHECK(counters.callbacksDelivered == 5);
+        CHECK(counters.manualFrames >= 4);
+        CHECK(counters.runCallbacksCalls == 0);
+        CHECK(mock->PendingCallbacks() == 0);
+
+        launcher.ShutdownUCOnline();
+        CHECK(!mock->IsInitialized());
+        CHECK(mock->GetCounters().shutdownCalls == 1);
+    }
+
+    void MachineConfigUnderGeneratedConfig() {
+        std::filesystem::path dir = std::filesystem::temp_directory_path() / "uc-online-tests" / "machine-config";
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+        std::filesystem::path machinePath = dir / "machine.ini";
+        std::ofstream(machinePath, std::ios::binary)
+            << "[uc-online]\n"
+            << "AppID = 730\n"
+            << "SteamApiDLLPath = /opt/steam\n";
+        SetEnvironment("UC_ONLINE_MACHINE_CONFIG", PathUtils::ToUtf8(machinePath));
+
+        {
+            // No config.ini yet, the launcher writes one with every default in it
+            std::filesystem::path gamePath = dir / "config.ini";
+            UCOnline64 launcher(std::make_shared<MockSteamBackend>(), PathUtils::ToUtf8(gamePath));
+            CHECK(std::filesystem::exists(gamePath));
+
+            const LayeredConfig& resolved = launcher.GetResolvedConfig();
+            CHECK(launcher.GetCurrentAppID() == 730);
+            CHECK(resolved.GetSource(ConfigKey::AppID) == ConfigLayer::Machine);
+            CHECK(resolved.GetSettings().Get<ConfigKey::SteamApiDLLPath>() == PathUtils::ToPath("/opt/steam"));
+            CHECK(resolved.GetSource(ConfigKey::SteamApiDLLPath) == ConfigLayer::Machine);
+            // Nobody set these anywhere
+            CHECK(resolved.GetSource(ConfigKey::CallbackRateHz) == ConfigLayer::Default);
+        }
+        {
+            // A real change in the game's ini still wins
+            std::filesystem::path gamePath = dir / "changed.ini";
+            std::ofstream(gamePath, std::ios::binary) << "[uc-online]\nAppID = 440\nSteamApiDLLPath =\n";
+            UCOnline64 launcher(std::make_shared<MockSteamBackend>(), PathUtils::ToUtf8(gamePath));
+            CHECK(launcher.GetCurrentAppID() == 440);
+            CHECK(launcher.GetResolvedConfig().GetSource(ConfigKey::AppID) == ConfigLayer::Game);
+            CHECK(launcher.GetResolvedConfig().GetSource(ConfigKey::SteamApiDLLPath) == ConfigLayer::Machine);
+        }
+        SetEnvironment("UC_ONLINE_MACHINE_CONFIG", "");
+    }
+
+    // Keeps what SaveConfig would have written
+    class MemoryWriter : public FileWriter {
+    public:
+        bool Write(const std::string&, std::string_view contents) override {
+            written.assign(contents);
+            return true;
+        }
+
+        std::string written;
+    };
+
+    void SaveKeepsLineFormatting() {
+        const std::string path = PathUtils::ToUtf8(std::filesystem::temp_directory_path() / "uc-online-tests" / "never-written.ini");
+        struct Case {
+            const char* input;
+            const char* expected;
+        };
+        // Only the value moves, however the line was spaced
+        const Case cases[] = {
+            {"[uc-online]\nAppID=480\n", "[uc-online]\nAppID=730\n"},
+            {"[uc-online]\nAppID = 480\n", "[uc-online]\nAppID = 730\n"},
+            {"[uc-online]\nAppID\t=\t480  \r\n", "[uc-online]\nAppID\t=\t730  \r\n"},
+            {"[uc-online]\nAppID=\n", "[uc-online]\nAppID=730\n"},
+            {"[uc-online]\nAppID = \n", "[uc-online]\nAppID = 730\n"},
+            {"[uc-online]\nAppID=480", "[uc-online]\nAppID=730"},
+        };
+        for (const Case& test : cases) {
+            auto writer = std::make_shared<MemoryWriter>();
+            IniConfig config(path, test.input, writer);
+            config.SetAppID(730);
+            config.SaveConfig();
+            CHECK(writer->written == test.expected);
+        }
+    }
+
+    std::string ReadFile(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+
+    void IntervalFlushWithoutPump() {
+        std::filesystem::path dir = std::filesystem::temp_directory_path() / "uc-online-tests" / "interval-flush";
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+        std::filesystem::path logPath = dir / "uc_online.log";
+        std::ofstream(dir / "config.ini", std::ios::binary)
+            << "[uc-online]\n"
+            << "AppID = 480\n"
+            << "WatchConfig = false\n"
+            << "[Logging]\n"
+            << "EnableLogging = true\n"
+            << "LogFile = " << PathUtils::ToUtf8(logPath) << "\n"
+            << "FlushPolicy = interval\n"
+            << "FlushIntervalMs = 100\n";
+        // Steam never comes up, so there's no callback pump to do the flushing
+        MockSteamBackend::Script script;
+        script.initResult = SteamInitResult::NoSteamClient;
+        UCOnline64 launcher(std::make_shared<MockSteamBackend>(script), PathUtils::ToUtf8(dir / "config.ini"));
+        CHECK(!launcher.InitializeUCOnline());
+
+        launcher.GetLogger()->Info("last line before going quiet");
+        bool flushed = false;
+        std::thread checker([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            flushed = ReadFile(logPath).find("last line before going quiet") != std::string::npos;
+            launcher.RequestExit();
+        });
+        CHECK(launcher.WaitForExit(std::chrono::milliseconds(0)) == ExitReason::Requested);
+        checker.join();
+        CHECK(flushed);
+    }
+
+    struct Test {
+        const char* name;
+        void (*run)();
+    };
+
+    const Test kTests[] = {
+        {"init_failure", &InitFailure},
+        {"restart_required", &RestartRequired},
+        {"missing_required_interface", &MissingRequiredInterface},
+        {"missing_optional_interface", &MissingOptionalInterface},
+        {"callback_stream_ends_in_shutdown", &CallbackStreamEndsInShutdown},
+        {"machine_config_under_generated_config", &MachineConfigUnderGeneratedConfig},
+        {"save_keeps_line_formatting", &SaveKeepsLineFormatting},
+        {"interval_flush_without_pump", &IntervalFlushWithoutPump},
+    };
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> wanted(argv + 1, argv + argc);
+    int ran = 0;
+    int failed = 0;
+    for (const Test& test : kTests) {
+        if (!wanted.empty() && std::find(wanted.begin(), wanted.end(), test.name) == wanted.end()) {
+            continue;
+        }
+        int before = g_failures;
+        test.run();
+        ran++;
+        bool passed = g_failures == before;
+        failed += passed ? 0 : 1;
+        std::cout << (passed ? "PASS " : "FAIL ") << test.name << std::endl;
+    }
+
+    if (ran == 0) {
+        std::cerr << "No test matched" << std::endl;
+        return 1;
+    }
+    std::cout << ran - failed << "/" << ran << " passed" << std::endl;
+    return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
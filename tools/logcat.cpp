@@ -0,0 +1,145 @@
+// Streams a binary log written by the "binary" sink back out as text.
+// Usage: uc-online-logcat <file.ulog> [--json]
+#include "binary_log_format.hpp"
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    const char* LevelName(uint8_t level) {
+        static const char* const names[] = { "DEBUG", "INFO", "WARNING", "ERROR", "EXCEPTION" };
+        return level < 5 ? names[level] : "UNKNOWN";
+    }
+
+    std::string FormatWallClock(uint64_t micros) {
+        std::time_t seconds = static_cast<std::time_t>(micros / 1000000);
+        std::tm tm;
+#ifdef _WIN32
+        localtime_s(&tm, &seconds);
+#else
+        localtime_r(&seconds, &tm);
+#endif
+        char buffer[40];
+        size_t length = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &tm);
+        std::snprintf(buffer + length, sizeof(buffer) - length, ".%06d", static_cast<int>(micros % 1000000));
+        return buffer;
+    }
+
+    std::string JsonEscape(const std::string& text) {
+        std::string out;
+        for (char c : text) {
+            switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out += escaped;
+                } else {
+                    out += c;
+                }
+            }
+        }
+        return out;
+    }
+
+    bool ReadExactly(std::istream& in, unsigned char* buffer, size_t size) {
+        in.read(reinterpret_cast<char*>(buffer), static_cast<std::streamsize>(size));
+        return static_cast<size_t>(in.gcount()) == size;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: uc-online-logcat <file.ulog> [--json]" << std::endl;
+        return 2;
+    }
+    bool json = argc > 2 && std::strcmp(argv[2], "--json") == 0;
+
+    std::ifstream in(argv[1], std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "Could not open " << argv[1] << std::endl;
+        return 1;
+    }
+
+    unsigned char magic[sizeof(BinaryLog::kMagic)];
+    if (!ReadExactly(in, magic, sizeof(magic)) || std::memcmp(magic, BinaryLog::kMagic, sizeof(magic)) != 0) {
+        std::cerr << "Not a uc-online binary log: " << argv[1] << std::endl;
+        return 1;
+    }
+
+    uint64_t sessionStart = 0;
+    unsigned char header[BinaryLog::kRecordHeaderSize];
+    std::string source;
+    std::string message;
+    // An entry cut short (gcount() less than asked for), e.g. the launcher died mid-write
+    bool truncated = false;
+    while (ReadExactly(in, header, 1)) {
+        if (header[0] == BinaryLog::kSessionEntry) {
+            if (!ReadExactly(in, header + 1, BinaryLog::kSessionSize - 1)) {
+                truncated = true;
+                break;
+            }
+            uint16_t version = static_cast<uint16_t>(BinaryLog::GetLE(header + 1, 2));
+            if (version > BinaryLog::kVersion) {
+                std::cerr << "Unsupported binary log version " << version << std::endl;
+                return 1;
+            }
+            sessionStart = BinaryLog::GetLE(header + 3, 8);
+            if (!json) {
+                std::cout << "--- session started " << FormatWallClock(sessionStart) << " ---" << std::endl;
+            }
+        } else if (header[0] == BinaryLog::kRecordEntry) {
+            if (!ReadExactly(in, header + 1, BinaryLog::kRecordHeaderSize - 1)) {
+                truncated = true;
+                break;
+            }
+            uint8_t level = header[1];
+            size_t sourceLength = static_cast<size_t>(BinaryLog::GetLE(header + 2, 2));
+            size_t messageLength = static_cast<size_t>(BinaryLog::GetLE(header + 4, 4));
+            uint64_t monotonicNs = BinaryLog::GetLE(header + 8, 8);
+            uint64_t threadId = BinaryLog::GetLE(header + 16, 8);
+
+            source.resize(sourceLength);
+            message.resize(messageLength);
+            if (!ReadExactly(in, reinterpret_cast<unsigned char*>(&source[0]), sourceLength) ||
+                !ReadExactly(in, reinterpret_cast<unsigned char*>(&message[0]), messageLength)) {
+                truncated = true;
+                break;
+            }
+
+            if (json) {
+                std::cout << "{\"ts\":\"" << FormatWallClock(sessionStart + monotonicNs / 1000)
+                          << "\",\"mono_ns\":" << monotonicNs
+                          << ",\"level\":\"" << LevelName(level)
+                          << "\",\"thread\":" << threadId
+                          << ",\"source\":\"" << JsonEscape(source)
+                          << "\",\"msg\":\"" << JsonEscape(message) << "\"}\n";
+            } else {
+                std::cout << FormatWallClock(sessionStart + monotonicNs / 1000)
+                          << " +" << std::fixed << std::setprecision(6) << (monotonicNs / 1e9) << "s"
+                          << " [" << LevelName(level) << "] "
+                          << "(" << threadId << ") "
+                          << (source.empty() ? "" : source + ": ") << message << "\n";
+            }
+        } else {
+            std::cerr << "Corrupt entry in binary log, stopping" << std::endl;
+            return 1;
+        }
+    }
+
+    if (truncated) {
+        std::cerr << "Truncated entry at end of binary log" << std::endl;
+        return 1;
+    }
+    return 0;
+}